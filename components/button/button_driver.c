@@ -31,6 +31,7 @@
 #include "ulp_lp_core_interrupts.h"
 
 #include "sw_timer.h"
+#include "system.h"
 
 #include "button_driver.h"
 
@@ -66,9 +67,6 @@
 #define GPIO_GET_LEVEL(_x) ulp_lp_core_gpio_get_level(_x)
 #endif
 
-/* LP core frequency in KHz */
-#define LP_CORE_FREQ_IN_KHZ 16000
-
 typedef enum {
     BUTTON_STATE_INVALID, /* not init */
     BUTTON_STATE_INIT, /* button created */
@@ -90,7 +88,7 @@ typedef struct {
     uint16_t short_press_time;
     sw_timer_handle_t timer_debounce;
     sw_timer_handle_t timer_long_press;
-    uint32_t tick_press_down; /* tick when button is push down */
+    uint64_t press_down_ms; /* system_clock_ms() when button is push down */
     gpio_num_t gpio;
     uint8_t state: 4;
     uint8_t active_level: 1;
@@ -120,7 +118,7 @@ static void btn_timer_cb_debounce(sw_timer_handle_t timer, void *args)
     case BUTTON_STATE_DEBOUNCE_PRESS_T:
         if (GPIO_GET_LEVEL(button->gpio) == button->active_level) {
             button->state = BUTTON_STATE_PRESS_DOWN;
-            button->tick_press_down = RV_READ_CSR(mcycle);
+            button->press_down_ms = system_clock_ms();
             sw_timer_start(button->timer_long_press);
         }
         else {
@@ -139,7 +137,7 @@ static void btn_timer_cb_debounce(sw_timer_handle_t timer, void *args)
                 button->cb_info[BUTTON_PRESS_UP].cb(button, button->cb_info[BUTTON_PRESS_UP].usr_data);
             }
 
-            uint32_t press_time = (RV_READ_CSR(mcycle) - button->tick_press_down) / LP_CORE_FREQ_IN_KHZ;
+            uint64_t press_time = system_clock_ms() - button->press_down_ms;
             if (press_time >= button->long_press_time) {
                 /* long press event */
                 if (button->cb_info[BUTTON_LONG_PRESS_UP].cb) {
@@ -234,6 +232,7 @@ button_handle_t button_driver_create(const button_config_t *config)
         .handler = btn_timer_cb_debounce,
         .periodic = false,
         .timeout_ms = BUTTON_DEBOUNCE_TIME,
+        .slack_ms = BUTTON_DEBOUNCE_TIME / 2, /* a slightly longer debounce is harmless */
     };
     sw_timer_handle_t timer_debounce = sw_timer_create(&timer_debounce_cfg);
 
@@ -332,13 +332,7 @@ esp_err_t ssd1306_init(display_ssd1306_handle_t dev)
 
 static int display_ssd1306_i2c_write(int i2c_port, uint16_t dev_addr, uint8_t *data, uint16_t data_len, int timeout)
 {
-    int timeout_tick = 0;
-    if (timeout == -1) {
-        timeout_tick = -1;
-    } else {
-        timeout_tick = timeout * 16000;
-    }
-    esp_err_t err = i2c_master_write_to_device(i2c_port, dev_addr, data, data_len, timeout_tick);
+    esp_err_t err = i2c_master_write_to_device(i2c_port, dev_addr, data, data_len, timeout);
     if (err != ESP_OK) {
         printf("%s: i2c write failed. err=%d\n", TAG, err);
         return -1;
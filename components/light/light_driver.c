@@ -514,6 +514,7 @@ void light_driver_effect_start(light_effect_config_t *config, int speed, int tot
         .handler = light_effect_handler,
         .periodic = true,
         .timeout_ms = effectStepTime, /* change brightness every half period */
+        .slack_ms = effectStepTime / 4, /* the step may run slightly late, the effect keeps its pace */
     };
     sw_timer_handle_t timer = sw_timer_create(&timer_cfg);
 
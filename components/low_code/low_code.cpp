@@ -13,18 +13,148 @@
 // limitations under the License.
 
 #include <string.h>
+#include <math.h>
+#include <sdkconfig.h>
+#include <profiler.h>
 
 #include "low_code.h"
 
+#ifdef CONFIG_LOW_CODE_MAX_FEATURE_HANDLERS
+#define LOW_CODE_MAX_FEATURE_HANDLERS CONFIG_LOW_CODE_MAX_FEATURE_HANDLERS
+#else
+#define LOW_CODE_MAX_FEATURE_HANDLERS 8
+#endif /* CONFIG_LOW_CODE_MAX_FEATURE_HANDLERS */
+
+#ifdef CONFIG_LOW_CODE_MAX_REPORT_CONFIGS
+#define LOW_CODE_MAX_REPORT_CONFIGS CONFIG_LOW_CODE_MAX_REPORT_CONFIGS
+#else
+#define LOW_CODE_MAX_REPORT_CONFIGS 4
+#endif /* CONFIG_LOW_CODE_MAX_REPORT_CONFIGS */
+
+#ifdef CONFIG_LOW_CODE_MAX_SUBSCRIBERS
+#define LOW_CODE_MAX_SUBSCRIBERS CONFIG_LOW_CODE_MAX_SUBSCRIBERS
+#else
+#define LOW_CODE_MAX_SUBSCRIBERS 8
+#endif /* CONFIG_LOW_CODE_MAX_SUBSCRIBERS */
+
+#ifdef CONFIG_LOW_CODE_MAX_FEATURE_STATES
+#define LOW_CODE_MAX_FEATURE_STATES CONFIG_LOW_CODE_MAX_FEATURE_STATES
+#else
+#define LOW_CODE_MAX_FEATURE_STATES 16
+#endif /* CONFIG_LOW_CODE_MAX_FEATURE_STATES */
+
+#ifdef CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE
+#define LOW_CODE_FEATURE_STATE_VALUE_SIZE CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE
+#else
+#define LOW_CODE_FEATURE_STATE_VALUE_SIZE 8
+#endif /* CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE */
+
+/* Number of updates of a batch which are filtered at a time */
+#define REPORT_BATCH_CHUNK 8
+
+/* The table is kept a power of two and at least twice the number of handlers, so that a lookup is a
+ * multiply, a mask and almost always a single probe */
+static constexpr uint32_t feature_handler_table_size(uint32_t count, uint32_t size = 1)
+{
+    return size >= 2 * count ? size : feature_handler_table_size(count, size << 1);
+}
+
+#define FEATURE_HANDLER_TABLE_SIZE feature_handler_table_size(LOW_CODE_MAX_FEATURE_HANDLERS)
+#define SUBSCRIBER_TABLE_SIZE feature_handler_table_size(LOW_CODE_MAX_SUBSCRIBERS)
+#define FEATURE_STATE_TABLE_SIZE feature_handler_table_size(LOW_CODE_MAX_FEATURE_STATES)
+
+/* value_len of a feature state whose last value was too long to be kept */
+#define FEATURE_STATE_VALUE_UNKNOWN 0xFF
+static_assert(LOW_CODE_FEATURE_STATE_VALUE_SIZE < FEATURE_STATE_VALUE_UNKNOWN, "feature state value_len is 8 bit");
+
+#define EVENT_TYPE_COUNT (LOW_CODE_EVENT_BLE_ADVERTISE + 1)
+
+/* The subscribers matching a filter are kept as a bit mask of their index */
+static_assert(LOW_CODE_MAX_SUBSCRIBERS <= 32, "subscriber masks are 32 bit");
+static_assert(EVENT_TYPE_COUNT <= 32, "event masks are 32 bit");
+
+/* Kinds of wildcard feature filters in use, to skip their lookup otherwise */
+#define SUBSCRIBER_ANY_ENDPOINT (1 << 0)
+#define SUBSCRIBER_ANY_FEATURE (1 << 1)
+
+typedef struct {
+    uint16_t endpoint_id;
+    low_code_feature_id_t feature_id;
+    low_code_feature_update_callback_t handler; /* NULL means an empty slot */
+} feature_handler_t;
+
+typedef struct {
+    bool valid;
+    bool reported;                  /* last_value and last_report_ms are set */
+    uint16_t endpoint_id;
+    low_code_feature_id_t feature_id;
+    low_code_report_config_t config;
+    float last_value;
+    uint32_t last_report_ms;
+} report_state_t;
+
+typedef struct {
+    bool is_event;
+    uint8_t priority;
+    uint16_t endpoint_id;
+    low_code_feature_id_t feature_id;
+    uint32_t event_mask;
+    union {
+        low_code_feature_update_callback_t feature_cb;
+        low_code_event_callback_t event_cb;
+    };
+} subscriber_t;
+
+typedef struct {
+    uint16_t endpoint_id;
+    low_code_feature_id_t feature_id;
+    uint32_t subscribers;           /* Mask of the subscribers with this filter, 0 means an empty slot */
+} subscriber_filter_t;
+
+typedef struct {
+    uint16_t endpoint_id;
+    uint8_t type;                   /* low_code_feature_value_type_t, LOW_CODE_VALUE_TYPE_INVALID means an empty slot */
+    uint8_t value_len;
+    low_code_feature_id_t feature_id;
+    uint8_t value[LOW_CODE_FEATURE_STATE_VALUE_SIZE];
+} feature_state_t;
+
 static const char *TAG = "low_code";
 
+static feature_handler_t feature_handlers[FEATURE_HANDLER_TABLE_SIZE];
+static int feature_handler_count = 0;
+
+static report_state_t report_states[LOW_CODE_MAX_REPORT_CONFIGS];
+static int report_state_count = 0;
+
+/* Last value of every (endpoint, feature) seen in either direction, in a table like the feature handlers */
+static feature_state_t feature_states[FEATURE_STATE_TABLE_SIZE];
+static int feature_state_count = 0;
+static low_code_feature_state_callback_t feature_state_callback = NULL;
+
+/* Sorted by priority, highest first. The filter table and the event masks index into it and are rebuilt
+ * whenever it changes, which keeps the dispatch to a few lookups and a walk over the matching bits. */
+static subscriber_t subscribers[LOW_CODE_MAX_SUBSCRIBERS];
+static int subscriber_count = 0;
+static subscriber_filter_t subscriber_filters[SUBSCRIBER_TABLE_SIZE];
+static uint32_t feature_subscribers = 0;
+static uint8_t subscriber_wildcards = 0;
+static uint32_t event_subscribers[EVENT_TYPE_COUNT];
+static bool subscribers_dispatching = false;
+
 static low_code_event_callback_t event_to_transport = NULL;
 static low_code_feature_update_callback_t feature_update_to_transport = NULL;
+static low_code_feature_update_batch_callback_t feature_update_batch_to_transport = NULL;
 static low_code_feature_update_callback_t feature_update_to_application = NULL;
 static low_code_event_callback_t event_to_application = NULL;
 
 low_code_get_event_from_system_t get_event_from_system = NULL;
 low_code_get_feature_update_from_system_t get_feature_from_system = NULL;
+low_code_hold_rx_buffer_t hold_rx_buffer = NULL;
+low_code_release_rx_buffer_t release_rx_buffer = NULL;
+low_code_feature_begin_t feature_begin_in_transport = NULL;
+low_code_feature_commit_t feature_commit_in_transport = NULL;
+low_code_get_time_ms_t get_time_ms = NULL;
 
 int low_code_event_from_transport(low_code_event_t *event)
 {
@@ -34,7 +164,17 @@ int low_code_event_from_transport(low_code_event_t *event)
     }
 
     if (event_to_application) {
-        event_to_application(event);
+        PROFILER_CALLBACK(PROFILER_CALLBACK_TRANSPORT, event_to_application, event_to_application(event));
+    }
+    if ((uint32_t)event->event_type < EVENT_TYPE_COUNT) {
+        uint32_t mask = event_subscribers[event->event_type];
+        subscribers_dispatching = true;
+        while (mask) {
+            low_code_event_callback_t callback = subscribers[__builtin_ctz(mask)].event_cb;
+            PROFILER_CALLBACK(PROFILER_CALLBACK_TRANSPORT, callback, callback(event));
+            mask &= mask - 1;
+        }
+        subscribers_dispatching = false;
     }
     return ESP_OK;
 }
@@ -47,27 +187,438 @@ int low_code_event_to_system(low_code_event_t *event)
     return ESP_OK;
 }
 
-int low_code_feature_update_from_transport(low_code_feature_data_t *data)
+static inline uint32_t feature_handler_hash(uint16_t endpoint_id, uint32_t feature_id)
+{
+    uint32_t hash = (feature_id ^ ((uint32_t)endpoint_id << 16)) * 0x9E3779B1;
+    return hash ^ (hash >> 16);
+}
+
+static feature_handler_t *feature_handler_find(uint16_t endpoint_id, uint32_t feature_id)
+{
+    uint32_t index = feature_handler_hash(endpoint_id, feature_id) & (FEATURE_HANDLER_TABLE_SIZE - 1);
+    /* Linear probing: the table is never more than half full, so an empty slot ends the search */
+    while (feature_handlers[index].handler) {
+        if (feature_handlers[index].endpoint_id == endpoint_id && feature_handlers[index].feature_id == feature_id) {
+            return &feature_handlers[index];
+        }
+        index = (index + 1) & (FEATURE_HANDLER_TABLE_SIZE - 1);
+    }
+    return &feature_handlers[index];
+}
+
+static subscriber_filter_t *subscriber_filter_find(uint16_t endpoint_id, uint32_t feature_id)
+{
+    uint32_t index = feature_handler_hash(endpoint_id, feature_id) & (SUBSCRIBER_TABLE_SIZE - 1);
+    while (subscriber_filters[index].subscribers) {
+        if (subscriber_filters[index].endpoint_id == endpoint_id && subscriber_filters[index].feature_id == feature_id) {
+            return &subscriber_filters[index];
+        }
+        index = (index + 1) & (SUBSCRIBER_TABLE_SIZE - 1);
+    }
+    return &subscriber_filters[index];
+}
+
+static feature_state_t *feature_state_find(uint16_t endpoint_id, uint32_t feature_id)
+{
+    uint32_t index = feature_handler_hash(endpoint_id, feature_id) & (FEATURE_STATE_TABLE_SIZE - 1);
+    while (feature_states[index].type != LOW_CODE_VALUE_TYPE_INVALID) {
+        if (feature_states[index].endpoint_id == endpoint_id && feature_states[index].feature_id == feature_id) {
+            return &feature_states[index];
+        }
+        index = (index + 1) & (FEATURE_STATE_TABLE_SIZE - 1);
+    }
+    return &feature_states[index];
+}
+
+/* Returns true if the state changed */
+static bool feature_state_set(const low_code_feature_data_t *data)
+{
+    const low_code_feature_value_t *value = &data->value;
+    if (value->type == LOW_CODE_VALUE_TYPE_INVALID || value->value_len < 0 || (value->value_len && !value->value)) {
+        return false;
+    }
+
+    feature_state_t *state = feature_state_find(data->details.endpoint_id, data->details.feature_id);
+    if (state->type == LOW_CODE_VALUE_TYPE_INVALID) {
+        if (feature_state_count >= LOW_CODE_MAX_FEATURE_STATES) {
+            return false;
+        }
+        state->endpoint_id = data->details.endpoint_id;
+        state->feature_id = data->details.feature_id;
+        feature_state_count++;
+        if (feature_state_count == LOW_CODE_MAX_FEATURE_STATES) {
+            printf("%s: Feature state table is full, max: %d\n", TAG, LOW_CODE_MAX_FEATURE_STATES);
+        }
+    }
+    if (value->value_len > LOW_CODE_FEATURE_STATE_VALUE_SIZE) {
+        bool changed = state->value_len != FEATURE_STATE_VALUE_UNKNOWN;
+        state->type = value->type;
+        state->value_len = FEATURE_STATE_VALUE_UNKNOWN;
+        return changed;
+    }
+    if (state->type == value->type && state->value_len == value->value_len &&
+            memcmp(state->value, value->value, value->value_len) == 0) {
+        return false;
+    }
+    state->type = value->type;
+    state->value_len = value->value_len;
+    memcpy(state->value, value->value, value->value_len);
+    return true;
+}
+
+static void feature_state_record(const low_code_feature_data_t *data)
+{
+    if (feature_state_set(data) && feature_state_callback) {
+        feature_state_callback(data);
+    }
+}
+
+int low_code_set_feature_state_callback(low_code_feature_state_callback_t callback)
+{
+    feature_state_callback = callback;
+    return ESP_OK;
+}
+
+int low_code_feature_state_restore(const low_code_feature_data_t *data)
 {
     if (!data) {
         printf("%s: Low Code feature data cannot be null\n", TAG);
         return ESP_ERR_INVALID_ARG;
     }
+    feature_state_set(data);
+    return ESP_OK;
+}
 
-    if (feature_update_to_application) {
-        feature_update_to_application(data);
+int low_code_feature_get(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_value_t *value)
+{
+    if (!value || (value->value_len && !value->value)) {
+        printf("%s: Low Code feature value cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const feature_state_t *state = feature_state_find(endpoint_id, feature_id);
+    if (state->type == LOW_CODE_VALUE_TYPE_INVALID || state->value_len == FEATURE_STATE_VALUE_UNKNOWN) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (value->value_len < state->value_len) {
+        value->value_len = state->value_len;
+        return ESP_ERR_INVALID_SIZE;
     }
+    value->type = (low_code_feature_value_type_t)state->type;
+    value->value_len = state->value_len;
+    memcpy(value->value, state->value, state->value_len);
     return ESP_OK;
 }
 
+static void feature_subscribers_notify(low_code_feature_data_t *data)
+{
+    uint16_t endpoint_id = data->details.endpoint_id;
+    uint32_t feature_id = data->details.feature_id;
+    uint32_t mask = subscriber_filter_find(endpoint_id, feature_id)->subscribers;
+    if (subscriber_wildcards & SUBSCRIBER_ANY_ENDPOINT) {
+        mask |= subscriber_filter_find(LOW_CODE_ENDPOINT_ID_ANY, feature_id)->subscribers;
+    }
+    if (subscriber_wildcards & SUBSCRIBER_ANY_FEATURE) {
+        mask |= subscriber_filter_find(endpoint_id, LOW_CODE_FEATURE_ID_ANY)->subscribers;
+        mask |= subscriber_filter_find(LOW_CODE_ENDPOINT_ID_ANY, LOW_CODE_FEATURE_ID_ANY)->subscribers;
+    }
+
+    /* Lower index is higher priority */
+    subscribers_dispatching = true;
+    while (mask) {
+        low_code_feature_update_callback_t callback = subscribers[__builtin_ctz(mask)].feature_cb;
+        PROFILER_CALLBACK(PROFILER_CALLBACK_TRANSPORT, callback, callback(data));
+        mask &= mask - 1;
+    }
+    subscribers_dispatching = false;
+}
+
+int low_code_feature_update_from_transport(low_code_feature_data_t *data)
+{
+    if (!data) {
+        printf("%s: Low Code feature data cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Recorded first, so that the handlers and the other components read the new value */
+    feature_state_record(data);
+
+    int ret = ESP_OK;
+    feature_handler_t *entry = feature_handler_find(data->details.endpoint_id, data->details.feature_id);
+    if (entry->handler) {
+        PROFILER_CALLBACK(PROFILER_CALLBACK_TRANSPORT, entry->handler, ret = entry->handler(data));
+    } else if (feature_update_to_application) {
+        PROFILER_CALLBACK(PROFILER_CALLBACK_TRANSPORT, feature_update_to_application, feature_update_to_application(data));
+    }
+
+    if (feature_subscribers) {
+        feature_subscribers_notify(data);
+    }
+    return ret;
+}
+
+static report_state_t *report_state_find(uint16_t endpoint_id, uint32_t feature_id)
+{
+    for (int i = 0; i < LOW_CODE_MAX_REPORT_CONFIGS; i++) {
+        if (report_states[i].valid && report_states[i].endpoint_id == endpoint_id && report_states[i].feature_id == feature_id) {
+            return &report_states[i];
+        }
+    }
+    return NULL;
+}
+
+/* Values are stored in little endian with their natural size */
+static bool feature_value_to_float(const low_code_feature_value_t *value, float *out)
+{
+    if (!value->value) {
+        return false;
+    }
+    switch (value->type) {
+    case LOW_CODE_VALUE_TYPE_BOOLEAN:
+        *out = value->value[0] ? 1.0f : 0.0f;
+        return value->value_len == 1;
+    case LOW_CODE_VALUE_TYPE_INTEGER:
+        if (value->value_len == sizeof(int8_t)) {
+            *out = (int8_t)value->value[0];
+        } else if (value->value_len == sizeof(int16_t)) {
+            int16_t v;
+            memcpy(&v, value->value, sizeof(v));
+            *out = v;
+        } else if (value->value_len == sizeof(int32_t)) {
+            int32_t v;
+            memcpy(&v, value->value, sizeof(v));
+            *out = v;
+        } else if (value->value_len == sizeof(int64_t)) {
+            int64_t v;
+            memcpy(&v, value->value, sizeof(v));
+            *out = v;
+        } else {
+            return false;
+        }
+        return true;
+    case LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER:
+        if (value->value_len == sizeof(uint8_t)) {
+            *out = value->value[0];
+        } else if (value->value_len == sizeof(uint16_t)) {
+            uint16_t v;
+            memcpy(&v, value->value, sizeof(v));
+            *out = v;
+        } else if (value->value_len == sizeof(uint32_t)) {
+            uint32_t v;
+            memcpy(&v, value->value, sizeof(v));
+            *out = v;
+        } else if (value->value_len == sizeof(uint64_t)) {
+            uint64_t v;
+            memcpy(&v, value->value, sizeof(v));
+            *out = v;
+        } else {
+            return false;
+        }
+        return true;
+    case LOW_CODE_VALUE_TYPE_FLOAT:
+        if (value->value_len != sizeof(float)) {
+            return false;
+        }
+        memcpy(out, value->value, sizeof(float));
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Check if the update has to be sent to the system. *value is set if it has to be recorded once sent. */
+static bool report_due(const report_state_t *state, const low_code_feature_value_t *feature_value, float *value, uint32_t now)
+{
+    if (!feature_value_to_float(feature_value, value)) {
+        return true;
+    }
+    if (!state->reported) {
+        return true;
+    }
+
+    const low_code_report_config_t *config = &state->config;
+    if (get_time_ms) {
+        uint32_t elapsed = now - state->last_report_ms;
+        if (config->max_interval_ms && elapsed >= config->max_interval_ms) {
+            return true;
+        }
+        if (elapsed < config->min_interval_ms) {
+            return false;
+        }
+    }
+
+    float change = fabsf(*value - state->last_value);
+    float deadband = fmaxf(config->absolute, config->relative * fabsf(state->last_value));
+    return deadband > 0 ? change >= deadband : change != 0;
+}
+
+static void report_record(report_state_t *state, float value, uint32_t now)
+{
+    state->reported = true;
+    state->last_value = value;
+    state->last_report_ms = now;
+}
+
 int low_code_feature_update_to_system(low_code_feature_data_t *feature)
 {
-    if (feature_update_to_transport) {
+    if (!feature) {
+        printf("%s: Low Code feature data cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* The state is the local value, also when its report is filtered out */
+    feature_state_record(feature);
+
+    if (!feature_update_to_transport) {
+        return ESP_OK;
+    }
+
+    report_state_t *state = report_state_count ? report_state_find(feature->details.endpoint_id, feature->details.feature_id) : NULL;
+    if (!state) {
         feature_update_to_transport(feature);
+        return ESP_OK;
+    }
+
+    float value = 0;
+    uint32_t now = get_time_ms ? get_time_ms() : 0;
+    if (!report_due(state, &feature->value, &value, now)) {
+        return ESP_OK;
     }
+    if (feature_update_to_transport(feature) == ESP_OK) {
+        report_record(state, value, now);
+    }
+    return ESP_OK;
+}
+
+int low_code_set_report_config(uint16_t endpoint_id, low_code_feature_id_t feature_id, const low_code_report_config_t *config)
+{
+    report_state_t *state = report_state_find(endpoint_id, feature_id);
+    if (!config) {
+        if (!state) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        memset(state, 0, sizeof(*state));
+        report_state_count--;
+        return ESP_OK;
+    }
+
+    if (config->absolute < 0 || config->relative < 0 ||
+        (config->max_interval_ms && config->max_interval_ms < config->min_interval_ms)) {
+        printf("%s: Invalid report config\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!state) {
+        for (int i = 0; i < LOW_CODE_MAX_REPORT_CONFIGS; i++) {
+            if (!report_states[i].valid) {
+                state = &report_states[i];
+                break;
+            }
+        }
+        if (!state) {
+            printf("%s: No space to set report config, max: %d\n", TAG, LOW_CODE_MAX_REPORT_CONFIGS);
+            return ESP_ERR_NO_MEM;
+        }
+        state->valid = true;
+        state->reported = false;
+        state->endpoint_id = endpoint_id;
+        state->feature_id = feature_id;
+        report_state_count++;
+    }
+    state->config = *config;
+
     return ESP_OK;
 }
 
+low_code_feature_data_t *low_code_feature_begin(int value_len)
+{
+    if (value_len < 0) {
+        printf("%s: Invalid value_len: %d\n", TAG, value_len);
+        return NULL;
+    }
+    if (!feature_begin_in_transport) {
+        printf("%s: Transport does not support in place feature updates\n", TAG);
+        return NULL;
+    }
+    return feature_begin_in_transport(value_len);
+}
+
+int low_code_feature_commit(low_code_feature_data_t *feature)
+{
+    if (!feature) {
+        printf("%s: Low Code feature data cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!feature_commit_in_transport) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    /* The value is in the transport buffer, which is gone once committed */
+    feature_state_record(feature);
+    return feature_commit_in_transport(feature);
+}
+
+int low_code_feature_update_to_system_batch(low_code_feature_data_t *features, int count)
+{
+    if (!features || count <= 0) {
+        printf("%s: Low Code feature batch cannot be empty\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (feature_update_batch_to_transport) {
+        for (int i = 0; i < count; i++) {
+            feature_state_record(&features[i]);
+        }
+        if (!report_state_count) {
+            return feature_update_batch_to_transport(features, count);
+        }
+
+        /* Only the updates which are due are copied, the values are not */
+        low_code_feature_data_t due[REPORT_BATCH_CHUNK];
+        report_state_t *due_states[REPORT_BATCH_CHUNK];
+        float due_values[REPORT_BATCH_CHUNK];
+        uint32_t now = get_time_ms ? get_time_ms() : 0;
+        int ret = ESP_OK;
+        int i = 0;
+        while (i < count) {
+            int due_count = 0;
+            for (; i < count && due_count < REPORT_BATCH_CHUNK; i++) {
+                report_state_t *state = report_state_find(features[i].details.endpoint_id, features[i].details.feature_id);
+                float value = 0;
+                if (state && !report_due(state, &features[i].value, &value, now)) {
+                    continue;
+                }
+                due[due_count] = features[i];
+                due_states[due_count] = state;
+                due_values[due_count] = value;
+                due_count++;
+            }
+            if (due_count == 0) {
+                continue;
+            }
+            int err = feature_update_batch_to_transport(due, due_count);
+            if (err != ESP_OK) {
+                ret = err;
+                continue;
+            }
+            for (int j = 0; j < due_count; j++) {
+                if (due_states[j]) {
+                    report_record(due_states[j], due_values[j], now);
+                }
+            }
+        }
+        return ret;
+    }
+
+    int ret = ESP_OK;
+    for (int i = 0; i < count; i++) {
+        int err = low_code_feature_update_to_system(&features[i]);
+        if (err != ESP_OK) {
+            ret = err;
+        }
+    }
+    return ret;
+}
+
 int low_code_register_transport_callbacks(low_code_callback_list_t *callbacks)
 {
     if (!callbacks) {
@@ -88,6 +639,12 @@ int low_code_register_transport_callbacks(low_code_callback_list_t *callbacks)
     feature_update_to_transport = callbacks->feature_update_cb;
     get_event_from_system  = callbacks->get_event;
     get_feature_from_system = callbacks->get_feature_update;
+    feature_update_batch_to_transport = callbacks->feature_update_batch_cb;
+    hold_rx_buffer = callbacks->hold_rx_buffer;
+    release_rx_buffer = callbacks->release_rx_buffer;
+    feature_begin_in_transport = callbacks->feature_begin;
+    feature_commit_in_transport = callbacks->feature_commit;
+    get_time_ms = callbacks->get_time_ms;
 
     return ESP_OK;
 }
@@ -108,6 +665,22 @@ int low_code_get_feature_update_from_system()
     return ESP_FAIL;
 }
 
+void *low_code_hold_rx_buffer()
+{
+    if (hold_rx_buffer) {
+        return hold_rx_buffer();
+    }
+    return NULL;
+}
+
+int low_code_release_rx_buffer(void *handle)
+{
+    if (release_rx_buffer) {
+        return release_rx_buffer(handle);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 int low_code_register_callbacks(low_code_feature_update_callback_t feature_update_cb, low_code_event_callback_t event_cb)
 {
     if (!feature_update_cb || !event_cb) {
@@ -125,3 +698,186 @@ int low_code_register_callbacks(low_code_feature_update_callback_t feature_updat
 
     return ESP_OK;
 }
+
+int low_code_register_feature_handler(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_update_callback_t handler)
+{
+    if (!handler) {
+        printf("%s: Feature handler cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    feature_handler_t *entry = feature_handler_find(endpoint_id, feature_id);
+    if (!entry->handler) {
+        if (feature_handler_count >= LOW_CODE_MAX_FEATURE_HANDLERS) {
+            printf("%s: No space to register feature handler, max: %d\n", TAG, LOW_CODE_MAX_FEATURE_HANDLERS);
+            return ESP_ERR_NO_MEM;
+        }
+        entry->endpoint_id = endpoint_id;
+        entry->feature_id = feature_id;
+        feature_handler_count++;
+    }
+    entry->handler = handler;
+
+    return ESP_OK;
+}
+
+static void subscribers_rebuild()
+{
+    memset(subscriber_filters, 0, sizeof(subscriber_filters));
+    memset(event_subscribers, 0, sizeof(event_subscribers));
+    feature_subscribers = 0;
+    subscriber_wildcards = 0;
+
+    for (int i = 0; i < subscriber_count; i++) {
+        subscriber_t *subscriber = &subscribers[i];
+        if (subscriber->is_event) {
+            for (int type = 0; type < EVENT_TYPE_COUNT; type++) {
+                if (subscriber->event_mask & LOW_CODE_EVENT_MASK(type)) {
+                    event_subscribers[type] |= 1UL << i;
+                }
+            }
+            continue;
+        }
+
+        subscriber_filter_t *filter = subscriber_filter_find(subscriber->endpoint_id, subscriber->feature_id);
+        filter->endpoint_id = subscriber->endpoint_id;
+        filter->feature_id = subscriber->feature_id;
+        filter->subscribers |= 1UL << i;
+        feature_subscribers |= 1UL << i;
+        if (subscriber->endpoint_id == LOW_CODE_ENDPOINT_ID_ANY) {
+            subscriber_wildcards |= SUBSCRIBER_ANY_ENDPOINT;
+        }
+        if (subscriber->feature_id == LOW_CODE_FEATURE_ID_ANY) {
+            subscriber_wildcards |= SUBSCRIBER_ANY_FEATURE;
+        }
+    }
+}
+
+static void subscriber_remove(int index)
+{
+    memmove(&subscribers[index], &subscribers[index + 1], (subscriber_count - index - 1) * sizeof(subscribers[0]));
+    subscriber_count--;
+}
+
+/* Insert keeping the list sorted by priority, after the subscribers with the same priority */
+static int subscriber_insert(const subscriber_t *subscriber)
+{
+    if (subscriber_count >= LOW_CODE_MAX_SUBSCRIBERS) {
+        printf("%s: No space to add subscriber, max: %d\n", TAG, LOW_CODE_MAX_SUBSCRIBERS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int index = 0;
+    while (index < subscriber_count && subscribers[index].priority >= subscriber->priority) {
+        index++;
+    }
+    memmove(&subscribers[index + 1], &subscribers[index], (subscriber_count - index) * sizeof(subscribers[0]));
+    subscribers[index] = *subscriber;
+    subscriber_count++;
+    return ESP_OK;
+}
+
+static int subscriber_feature_find(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_update_callback_t callback)
+{
+    for (int i = 0; i < subscriber_count; i++) {
+        if (!subscribers[i].is_event && subscribers[i].endpoint_id == endpoint_id && subscribers[i].feature_id == feature_id &&
+                subscribers[i].feature_cb == callback) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int subscriber_event_find(low_code_event_callback_t callback)
+{
+    for (int i = 0; i < subscriber_count; i++) {
+        if (subscribers[i].is_event && subscribers[i].event_cb == callback) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int low_code_subscribe_feature_update(uint16_t endpoint_id, low_code_feature_id_t feature_id, uint8_t priority, low_code_feature_update_callback_t callback)
+{
+    if (!callback) {
+        printf("%s: Subscriber callback cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (subscribers_dispatching) {
+        printf("%s: Subscriptions cannot be changed from a subscriber\n", TAG);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int index = subscriber_feature_find(endpoint_id, feature_id, callback);
+    if (index >= 0) {
+        subscriber_remove(index);
+    }
+
+    subscriber_t subscriber = {};
+    subscriber.priority = priority;
+    subscriber.endpoint_id = endpoint_id;
+    subscriber.feature_id = feature_id;
+    subscriber.feature_cb = callback;
+    int ret = subscriber_insert(&subscriber);
+    subscribers_rebuild();
+    return ret;
+}
+
+int low_code_unsubscribe_feature_update(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_update_callback_t callback)
+{
+    if (subscribers_dispatching) {
+        printf("%s: Subscriptions cannot be changed from a subscriber\n", TAG);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int index = subscriber_feature_find(endpoint_id, feature_id, callback);
+    if (index < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    subscriber_remove(index);
+    subscribers_rebuild();
+    return ESP_OK;
+}
+
+int low_code_subscribe_event(uint32_t event_mask, uint8_t priority, low_code_event_callback_t callback)
+{
+    if (!callback) {
+        printf("%s: Subscriber callback cannot be null\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (subscribers_dispatching) {
+        printf("%s: Subscriptions cannot be changed from a subscriber\n", TAG);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int index = subscriber_event_find(callback);
+    if (index >= 0) {
+        subscriber_remove(index);
+    }
+
+    subscriber_t subscriber = {};
+    subscriber.is_event = true;
+    subscriber.priority = priority;
+    subscriber.event_mask = event_mask;
+    subscriber.event_cb = callback;
+    int ret = subscriber_insert(&subscriber);
+    subscribers_rebuild();
+    return ret;
+}
+
+int low_code_unsubscribe_event(low_code_event_callback_t callback)
+{
+    if (subscribers_dispatching) {
+        printf("%s: Subscriptions cannot be changed from a subscriber\n", TAG);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int index = subscriber_event_find(callback);
+    if (index < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    subscriber_remove(index);
+    subscribers_rebuild();
+    return ESP_OK;
+}
@@ -176,9 +176,22 @@ typedef int (*low_code_event_callback_t)(low_code_event_t *event);
  */
 typedef int (*low_code_feature_update_callback_t)(low_code_feature_data_t *data);
 
+/**
+ * @brief Batched feature update callback function type
+ * @param[in] data Array of feature data structures
+ * @param[in] count Number of entries in the array
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+typedef int (*low_code_feature_update_batch_callback_t)(low_code_feature_data_t *data, int count);
+
 /* Internal callback types */
 typedef int (*low_code_get_event_from_system_t)();
 typedef int (*low_code_get_feature_update_from_system_t)();
+typedef void *(*low_code_hold_rx_buffer_t)();
+typedef int (*low_code_release_rx_buffer_t)(void *handle);
+typedef low_code_feature_data_t *(*low_code_feature_begin_t)(int value_len);
+typedef int (*low_code_feature_commit_t)(low_code_feature_data_t *feature);
+typedef uint32_t (*low_code_get_time_ms_t)();
 
 /**
  * @brief Structure containing all callback functions
@@ -188,8 +201,28 @@ typedef struct low_code_callback_list {
     low_code_feature_update_callback_t feature_update_cb; /*!< Feature update callback */
     low_code_get_event_from_system_t get_event; /*!< Get event callback */
     low_code_get_feature_update_from_system_t get_feature_update; /*!< Get feature update callback */
+    low_code_feature_update_batch_callback_t feature_update_batch_cb; /*!< Batched feature update callback (optional) */
+    low_code_hold_rx_buffer_t hold_rx_buffer; /*!< Hold the receive buffer being dispatched (optional) */
+    low_code_release_rx_buffer_t release_rx_buffer; /*!< Release a held receive buffer (optional) */
+    low_code_feature_begin_t feature_begin; /*!< Allocate a feature update in the transmit buffer (optional) */
+    low_code_feature_commit_t feature_commit; /*!< Send a feature update allocated with feature_begin (optional) */
+    low_code_get_time_ms_t get_time_ms;     /*!< Monotonic time in milliseconds, used for report intervals (optional) */
 } __attribute__((packed)) low_code_callback_list_t;
 
+/**
+ * @brief Report configuration of a feature
+ *
+ * Similar to the reportable change of a Matter attribute: a new value is sent to the system if it has changed
+ * by more than the deadband and min_interval_ms has passed since the last report, or if max_interval_ms has
+ * passed since the last report. If both absolute and relative are set, the larger deadband applies.
+ */
+typedef struct low_code_report_config {
+    float absolute;                         /*!< Minimum change of the value to report, 0 to report any change */
+    float relative;                         /*!< Minimum change as a fraction of the last reported value, 0 to disable */
+    uint32_t min_interval_ms;               /*!< Minimum time between two reports */
+    uint32_t max_interval_ms;               /*!< Report even if unchanged once this much time has passed, 0 to disable */
+} low_code_report_config_t;
+
 /**
  * @brief Register transport layer callbacks
  * @param[in] callbacks Pointer to the callback list structure
@@ -219,13 +252,195 @@ int low_code_event_from_transport(low_code_event_t *event);
  */
 int low_code_register_callbacks(low_code_feature_update_callback_t feature_update_from_system, low_code_event_callback_t event_from_system);
 
+/**
+ * @brief Register a handler for a feature of an endpoint
+ *
+ * Feature updates from the system for this (endpoint_id, feature_id) pair are dispatched directly
+ * to the handler. Updates without a registered handler are passed to the feature update callback
+ * registered with low_code_register_callbacks(). Registering the same pair again replaces the handler.
+ *
+ * The handlers are kept in a statically sized hash table (CONFIG_LOW_CODE_MAX_FEATURE_HANDLERS entries),
+ * so the dispatch cost does not grow with the number of endpoints and features.
+ * @param[in] endpoint_id Endpoint identifier
+ * @param[in] feature_id Feature identifier
+ * @param[in] handler Feature update callback function
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_register_feature_handler(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_update_callback_t handler);
+
+/** @brief Endpoint filter of low_code_subscribe_feature_update() matching all the endpoints */
+#define LOW_CODE_ENDPOINT_ID_ANY 0xFFFF
+
+/** @brief Feature filter of low_code_subscribe_feature_update() matching all the features */
+#define LOW_CODE_FEATURE_ID_ANY LOW_CODE_FEATURE_ID_MAX
+
+/** @brief Event filter of low_code_subscribe_event() matching an event type */
+#define LOW_CODE_EVENT_MASK(event_type) (1UL << (event_type))
+
+/** @brief Event filter of low_code_subscribe_event() matching all the event types */
+#define LOW_CODE_EVENT_MASK_ALL UINT32_MAX
+
+/**
+ * @brief Subscribe to feature updates from the system
+ *
+ * Unlike the callbacks registered with low_code_register_callbacks(), any number of components (e.g. a display
+ * or an indicator LED) can observe the feature updates this way. Every update is first passed to its feature
+ * handler or the application callback, and then to the matching subscribers, highest priority first.
+ * Subscribers with the same priority are called in the order they subscribed.
+ *
+ * Only the subscribers whose filter matches are called, the others add nothing to the dispatch cost. The
+ * subscribers are kept in a statically sized list (CONFIG_LOW_CODE_MAX_SUBSCRIBERS entries, shared with
+ * low_code_subscribe_event()). Subscribing the same filter and callback again changes its priority.
+ * Subscriptions cannot be changed from within a subscriber callback.
+ * @param[in] endpoint_id Endpoint identifier, LOW_CODE_ENDPOINT_ID_ANY for all the endpoints
+ * @param[in] feature_id Feature identifier, LOW_CODE_FEATURE_ID_ANY for all the features
+ * @param[in] priority Priority of the subscriber, higher is called first
+ * @param[in] callback Feature update callback function
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_subscribe_feature_update(uint16_t endpoint_id, low_code_feature_id_t feature_id, uint8_t priority, low_code_feature_update_callback_t callback);
+
+/**
+ * @brief Remove a subscription made with low_code_subscribe_feature_update()
+ * @param[in] endpoint_id Endpoint identifier used to subscribe
+ * @param[in] feature_id Feature identifier used to subscribe
+ * @param[in] callback Feature update callback function used to subscribe
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_unsubscribe_feature_update(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_update_callback_t callback);
+
+/**
+ * @brief Subscribe to events from the system
+ *
+ * Every event is first passed to the application callback, and then to the subscribers whose event_mask
+ * contains it, in the same order as for low_code_subscribe_feature_update(). Subscribing the same callback
+ * again replaces its event_mask and priority.
+ * @param[in] event_mask Event types to receive, LOW_CODE_EVENT_MASK() of each or LOW_CODE_EVENT_MASK_ALL
+ * @param[in] priority Priority of the subscriber, higher is called first
+ * @param[in] callback Event callback function
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_subscribe_event(uint32_t event_mask, uint8_t priority, low_code_event_callback_t callback);
+
+/**
+ * @brief Remove a subscription made with low_code_subscribe_event()
+ * @param[in] callback Event callback function used to subscribe
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_unsubscribe_event(low_code_event_callback_t callback);
+
 /**
  * @brief Send feature update to system
+ *
+ * If a report configuration is set for the feature with low_code_set_report_config(), updates which do not
+ * need to be reported are dropped here and ESP_OK is returned.
  * @param[in] feature Pointer to the feature data structure
  * @return ESP_OK on success, appropriate error code otherwise
  */
 int low_code_feature_update_to_system(low_code_feature_data_t *feature);
 
+/**
+ * @brief Set the report configuration of a feature of an endpoint
+ *
+ * Updates sent with low_code_feature_update_to_system() and low_code_feature_update_to_system_batch() are
+ * compared with the last reported value, and only sent to the system as described in low_code_report_config_t.
+ * This avoids waking up the system and sending radio traffic for values which have not changed meaningfully,
+ * e.g. a temperature sampled every few seconds. The first update is always sent.
+ *
+ * Only boolean, integer, unsigned integer and float values are compared, other value types are always sent.
+ * Updates dropped within min_interval_ms are not sent later, the next update after it is compared with the
+ * last reported value again. The intervals need the get_time_ms transport callback, without it only the
+ * deadband applies.
+ *
+ * The configurations are kept in a statically sized table (CONFIG_LOW_CODE_MAX_REPORT_CONFIGS entries).
+ * @param[in] endpoint_id Endpoint identifier
+ * @param[in] feature_id Feature identifier
+ * @param[in] config Report configuration, NULL to remove the configuration and send all the updates
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_set_report_config(uint16_t endpoint_id, low_code_feature_id_t feature_id, const low_code_report_config_t *config);
+
+/**
+ * @brief Get the last known value of a feature of an endpoint
+ *
+ * low_code keeps the last value of every feature update received from the system and sent to it, so that the
+ * application and the components can read the current state without keeping their own copy. Updates received
+ * from the system are recorded before their handler is called. Updates filtered out by the report
+ * configuration are recorded too, since they are still the local value.
+ *
+ * The values are kept in a statically sized table (CONFIG_LOW_CODE_MAX_FEATURE_STATES entries), values longer
+ * than CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE are not kept. Use low_code::feature_get() from
+ * low_code_feature.h to read a value as the type of the feature.
+ * @param[in] endpoint_id Endpoint identifier
+ * @param[in] feature_id Feature identifier
+ * @param[inout] value value->value points to a buffer of value->value_len bytes. On success, the value is copied
+ *                     into it and value->type and value->value_len are set.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the value is not known, ESP_ERR_INVALID_SIZE if the buffer is
+ *         too small (value->value_len is set to the length of the value), appropriate error code otherwise
+ */
+int low_code_feature_get(uint16_t endpoint_id, low_code_feature_id_t feature_id, low_code_feature_value_t *value);
+
+/**
+ * @brief Callback type called when the last known value of a feature changes
+ */
+typedef void (*low_code_feature_state_callback_t)(const low_code_feature_data_t *data);
+
+/**
+ * @brief Set the function called when the last known value of a feature changes
+ *
+ * This is used by the system to keep a copy of the feature states which survives a reset of the LP core.
+ * It is also called once when the value becomes too long to be kept, see low_code_feature_get().
+ * @param[in] callback Callback function, NULL to remove it
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_set_feature_state_callback(low_code_feature_state_callback_t callback);
+
+/**
+ * @brief Set the last known value of a feature without sending or dispatching it
+ *
+ * This is used by the system to restore the feature states after a reset of the LP core. The feature state
+ * callback is not called.
+ * @param[in] data Feature data to record
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_feature_state_restore(const low_code_feature_data_t *data);
+
+/**
+ * @brief Start a feature update to system which is serialized in place
+ *
+ * The transmit message is allocated right away and the returned feature data lives inside it, with
+ * value.value pointing to value_len bytes of space for the value. Fill in the details and value.type,
+ * write the value at value.value and send it with low_code_feature_commit(). This avoids building the
+ * value separately and copying it into the message, which matters for large values like arrays and
+ * octet strings. value.value_len may be reduced before committing, but not increased.
+ *
+ * Only one update can be in progress at a time, and every successful begin must be committed.
+ * Report configurations set with low_code_set_report_config() do not apply to these updates.
+ * @param[in] value_len Maximum length of the value
+ * @return Pointer to the feature data to fill, NULL on failure
+ */
+low_code_feature_data_t *low_code_feature_begin(int value_len);
+
+/**
+ * @brief Send a feature update started with low_code_feature_begin()
+ * @param[in] feature Pointer returned by low_code_feature_begin()
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if value.value_len was increased (nothing is sent then),
+ *         appropriate error code otherwise
+ */
+int low_code_feature_commit(low_code_feature_data_t *feature);
+
+/**
+ * @brief Send multiple feature updates to system
+ *
+ * All the updates are packed into as few messages as possible, e.g. power, brightness and color
+ * temperature of a light changed together are sent as a single message. If the transport does not
+ * support batching, the updates are sent one by one.
+ * @param[in] features Array of feature data structures
+ * @param[in] count Number of entries in the array
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_feature_update_to_system_batch(low_code_feature_data_t *features, int count);
+
 /**
  * @brief Send event to system
  * @param[in] event Pointer to the event structure
@@ -244,3 +459,23 @@ int low_code_get_feature_update_from_system();
  * @return ESP_OK on success, appropriate error code otherwise
  */
 int low_code_get_event_from_system();
+
+/**
+ * @brief Keep the receive buffer of the feature update or event being handled
+ *
+ * By default the data passed to the feature update and event callbacks is only valid until the callback
+ * returns. When the transport hands out the data in place (zero copy receive), calling this from within
+ * the callback keeps the underlying buffer, and the data in it, valid until low_code_release_rx_buffer()
+ * is called. Held buffers are not available to the system for sending further messages, so release them
+ * as soon as possible. The records of a batched update share one buffer: every call returns the same handle
+ * for them, and each call must be matched by one low_code_release_rx_buffer().
+ * @return Handle of the held buffer, NULL if the data is not in place (it must be copied then)
+ */
+void *low_code_hold_rx_buffer();
+
+/**
+ * @brief Release a receive buffer held with low_code_hold_rx_buffer()
+ * @param[in] handle Handle returned by low_code_hold_rx_buffer()
+ * @return ESP_OK on success, appropriate error code otherwise
+ */
+int low_code_release_rx_buffer(void *handle);
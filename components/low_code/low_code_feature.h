@@ -0,0 +1,213 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file low_code_feature.h
+ * @brief Typed access to feature values
+ *
+ * The value type of every feature is known at compile time, so the value of a feature update can be read and
+ * written as its C++ type instead of casting low_code_feature_value_t::value:
+ *
+ * @code
+ * int light_brightness_update_from_system(low_code_feature_data_t *data)
+ * {
+ *     uint8_t brightness = low_code::feature_value<LOW_CODE_FEATURE_ID_BRIGHTNESS>(data);
+ *     ...
+ * }
+ *
+ * auto update = low_code::make_feature<LOW_CODE_FEATURE_ID_POWER>(1, power);
+ * low_code_feature_update_to_system(&update.data);
+ *
+ * bool power = false;
+ * low_code::feature_get<LOW_CODE_FEATURE_ID_POWER>(1, &power);
+ * @endcode
+ *
+ * Using a feature without a value type below, or creating an update with a value of another type, fails to build.
+ */
+
+#pragma once
+
+#include <string.h>
+#include <type_traits>
+
+#include "low_code.h"
+
+namespace low_code {
+
+/**
+ * @brief Value type of a feature, only defined for the features listed below
+ */
+template <low_code_feature_id_t FeatureId>
+struct feature_traits;
+
+#define LOW_CODE_FEATURE_VALUE_TYPE(feature_id, value_t) \
+    template <> \
+    struct feature_traits<feature_id> { \
+        using type = value_t; \
+    }
+
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_POWER, bool);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_BRIGHTNESS, uint8_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE, uint16_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_HUE, uint8_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_SATURATION, uint8_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_TEMPERATURE, int16_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_COOLING_SETPOINT, int16_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_HEATING_SETPOINT, int16_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_TEMPERATURE_SENSOR_VALUE, int16_t);
+LOW_CODE_FEATURE_VALUE_TYPE(LOW_CODE_FEATURE_ID_OCCUPANCY_SENSOR_VALUE, uint8_t);
+
+#undef LOW_CODE_FEATURE_VALUE_TYPE
+
+/**
+ * @brief C++ type of the value of a feature
+ */
+template <low_code_feature_id_t FeatureId>
+using feature_value_t = typename feature_traits<FeatureId>::type;
+
+/**
+ * @brief low_code_feature_value_type_t of a C++ type
+ */
+template <typename T>
+constexpr low_code_feature_value_type_t value_type()
+{
+    static_assert(std::is_arithmetic_v<T>, "feature values are bool, integers or float");
+    static_assert(!std::is_floating_point_v<T> || std::is_same_v<T, float>, "float is the only floating point value type");
+    if constexpr (std::is_same_v<T, bool>) {
+        return LOW_CODE_VALUE_TYPE_BOOLEAN;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return LOW_CODE_VALUE_TYPE_FLOAT;
+    } else if constexpr (std::is_signed_v<T>) {
+        return LOW_CODE_VALUE_TYPE_INTEGER;
+    } else {
+        return LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER;
+    }
+}
+
+/**
+ * @brief Read a value as T
+ *
+ * This is a single load, the type and length of the value are not checked. Use feature_value_get() for
+ * values which may not be of type T.
+ * @param[in] value Feature value of type T
+ * @return The value
+ */
+template <typename T>
+inline T feature_value(const low_code_feature_value_t &value)
+{
+    static_assert(value_type<T>() != LOW_CODE_VALUE_TYPE_INVALID);
+    T out;
+    /* The value may not be aligned */
+    memcpy(&out, value.value, sizeof(out));
+    return out;
+}
+
+/**
+ * @brief Read the value of a feature update as the type of the feature
+ *
+ * This is a single load, like feature_value<T>(). The feature ID of the update is not checked, use it in
+ * handlers registered for FeatureId or after comparing data->details.feature_id.
+ * @param[in] data Feature update of FeatureId
+ * @return The value
+ */
+template <low_code_feature_id_t FeatureId>
+inline feature_value_t<FeatureId> feature_value(const low_code_feature_data_t *data)
+{
+    return feature_value<feature_value_t<FeatureId>>(data->value);
+}
+
+/**
+ * @brief Read the value of a feature update after checking its feature ID, type and length
+ * @param[in] data Feature update
+ * @param[out] out The value
+ * @return true if data is an update of FeatureId with a value of its type, false otherwise
+ */
+template <low_code_feature_id_t FeatureId>
+inline bool feature_value_get(const low_code_feature_data_t *data, feature_value_t<FeatureId> *out)
+{
+    using T = feature_value_t<FeatureId>;
+    if (data->details.feature_id != FeatureId || data->value.type != value_type<T>() ||
+            data->value.value_len != sizeof(T) || !data->value.value) {
+        return false;
+    }
+    *out = feature_value<T>(data->value);
+    return true;
+}
+
+/**
+ * @brief Get the last known value of a feature as the type of the feature
+ *
+ * This is low_code_feature_get() with a check of the value type and length.
+ * @param[in] endpoint_id Endpoint identifier
+ * @param[out] out The value
+ * @return true if the value is known and of the type of the feature, false otherwise
+ */
+template <low_code_feature_id_t FeatureId>
+inline bool feature_get(uint16_t endpoint_id, feature_value_t<FeatureId> *out)
+{
+    using T = feature_value_t<FeatureId>;
+    T v;
+    low_code_feature_value_t value = {};
+    value.value_len = sizeof(T);
+    value.value = (uint8_t *)&v;
+    if (low_code_feature_get(endpoint_id, FeatureId, &value) != ESP_OK || value.type != value_type<T>() ||
+            value.value_len != sizeof(T)) {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+/**
+ * @brief Feature update holding its own value, created with make_feature()
+ *
+ * data.value.value points to value, so it cannot be copied or moved.
+ */
+template <low_code_feature_id_t FeatureId>
+struct feature {
+    feature_value_t<FeatureId> value;       /*!< Value of the update */
+    low_code_feature_data_t data;           /*!< Feature update to pass to low_code_feature_update_to_system() */
+
+    feature(uint16_t endpoint_id, feature_value_t<FeatureId> v) : value(v), data()
+    {
+        data.details.endpoint_id = endpoint_id;
+        data.details.feature_id = FeatureId;
+        data.value.type = value_type<feature_value_t<FeatureId>>();
+        data.value.value_len = sizeof(value);
+        data.value.value = (uint8_t *)&value;
+    }
+
+    feature(const feature &) = delete;
+    feature &operator=(const feature &) = delete;
+};
+
+/**
+ * @brief Create a feature update with the type of the feature
+ *
+ * v must be of the same kind (bool, signed or unsigned integer, float) as the value type of the feature, and
+ * not larger, e.g. an int for LOW_CODE_FEATURE_ID_BRIGHTNESS (uint8_t) fails to build. Cast it explicitly.
+ * @param[in] endpoint_id Endpoint identifier
+ * @param[in] v Value
+ * @return Feature update, pass its data member to low_code_feature_update_to_system()
+ */
+template <low_code_feature_id_t FeatureId, typename V>
+inline feature<FeatureId> make_feature(uint16_t endpoint_id, V v)
+{
+    using T = feature_value_t<FeatureId>;
+    static_assert(value_type<V>() == value_type<T>(), "value is not of the value type of the feature");
+    static_assert(sizeof(V) <= sizeof(T), "value is larger than the value type of the feature");
+    return feature<FeatureId>(endpoint_id, v);
+}
+
+} /* namespace low_code */
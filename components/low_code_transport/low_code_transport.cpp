@@ -15,90 +15,1127 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 
+#include <sdkconfig.h>
 #include <esp_amp.h>
+#include <esp_amp_sw_intr.h>
+#include <esp_amp_platform.h>
 #include <ulp_lp_core_utils.h>
+#include <riscv/rv_utils.h>
 #include <low_code.h>
 #include <low_code_transport.h>
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+#include <low_code_transport_wire.h>
+#endif
 
 #define ESP_AMP_ENDPOINT_FEATURE 0
 #define ESP_AMP_ENDPOINT_EVENT 1
+#define ESP_AMP_ENDPOINT_FEATURE_BATCH 2
+#define ESP_AMP_ENDPOINT_FRAGMENT 3
+#define ESP_AMP_ENDPOINT_EVENT_PRIORITY 4
 #define ESP_AMP_EVENT_SUBCORE_READY (1 << 0)
 
 #define BUF_SIZE 256
 
+#ifdef CONFIG_LOW_CODE_TRANSPORT_RX_QUEUE_LEN
+#define RX_QUEUE_LEN CONFIG_LOW_CODE_TRANSPORT_RX_QUEUE_LEN
+#else
+#define RX_QUEUE_LEN 4
+#endif /* CONFIG_LOW_CODE_TRANSPORT_RX_QUEUE_LEN */
+
+#ifdef CONFIG_LOW_CODE_TRANSPORT_EVENT_POLL_BUDGET
+#define EVENT_POLL_BUDGET CONFIG_LOW_CODE_TRANSPORT_EVENT_POLL_BUDGET
+#else
+#define EVENT_POLL_BUDGET 4
+#endif /* CONFIG_LOW_CODE_TRANSPORT_EVENT_POLL_BUDGET */
+
+#ifdef CONFIG_LOW_CODE_TRANSPORT_FEATURE_POLL_BUDGET
+#define FEATURE_POLL_BUDGET CONFIG_LOW_CODE_TRANSPORT_FEATURE_POLL_BUDGET
+#else
+#define FEATURE_POLL_BUDGET 2
+#endif /* CONFIG_LOW_CODE_TRANSPORT_FEATURE_POLL_BUDGET */
+
+#ifdef CONFIG_LOW_CODE_TRANSPORT_STATS_DUMP_INTERVAL_MS
+#define STATS_DUMP_INTERVAL_MS CONFIG_LOW_CODE_TRANSPORT_STATS_DUMP_INTERVAL_MS
+#else
+#define STATS_DUMP_INTERVAL_MS 0
+#endif /* CONFIG_LOW_CODE_TRANSPORT_STATS_DUMP_INTERVAL_MS */
+
+#ifdef CONFIG_LOW_CODE_TRANSPORT_PENDING_QUEUE_LEN
+#define PENDING_QUEUE_LEN CONFIG_LOW_CODE_TRANSPORT_PENDING_QUEUE_LEN
+#else
+#define PENDING_QUEUE_LEN 4
+#endif /* CONFIG_LOW_CODE_TRANSPORT_PENDING_QUEUE_LEN */
+
+#ifdef CONFIG_LOW_CODE_TRANSPORT_PENDING_VALUE_MAX_LEN
+#define PENDING_VALUE_MAX_LEN CONFIG_LOW_CODE_TRANSPORT_PENDING_VALUE_MAX_LEN
+#else
+#define PENDING_VALUE_MAX_LEN 16
+#endif /* CONFIG_LOW_CODE_TRANSPORT_PENDING_VALUE_MAX_LEN */
+
+#ifdef CONFIG_LOW_CODE_TRANSPORT_REASSEMBLY_BUF_SIZE
+#define REASSEMBLY_BUF_SIZE CONFIG_LOW_CODE_TRANSPORT_REASSEMBLY_BUF_SIZE
+#else
+#define REASSEMBLY_BUF_SIZE 1024
+#endif /* CONFIG_LOW_CODE_TRANSPORT_REASSEMBLY_BUF_SIZE */
+
+/* Upper bound of the first latency histogram bucket, each further bucket doubles it. 16 us at 16 MHz. */
+#define LATENCY_BUCKET_0_CYCLES 256
+
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+/* Records are encoded with low_code_transport_wire.h */
+#define FEATURE_RECORD_ALIGN LOW_CODE_WIRE_ALIGN
+#define EVENT_RECORD_ALIGN LOW_CODE_WIRE_ALIGN
+#define FEATURE_BEGIN_HEADER_LEN LOW_CODE_WIRE_FEATURE_HEADER_MAX_LEN
+#else
+/* Records are the raw low_code_feature_data_t or low_code_event_t followed by the value */
+#define FEATURE_RECORD_ALIGN alignof(low_code_feature_data_t)
+#define EVENT_RECORD_ALIGN alignof(low_code_event_t)
+#define FEATURE_BEGIN_HEADER_LEN sizeof(low_code_feature_data_t)
+#endif
+
+/* Records in a batch message start at aligned offsets, so that they can be handed to the application in place */
+#define BATCH_RECORD_ALIGN(x) (((x) + FEATURE_RECORD_ALIGN - 1) & ~(FEATURE_RECORD_ALIGN - 1))
+
+/* Header of a message on ESP_AMP_ENDPOINT_FEATURE_BATCH. It is followed by `count` feature records, each
+ * padded to BATCH_RECORD_ALIGN */
+typedef struct {
+    uint16_t count;
+    uint16_t reserved;
+} feature_batch_header_t;
+
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+/* Header of a message on ESP_AMP_ENDPOINT_FRAGMENT. A feature or event record (the same as sent on its own
+ * endpoint) which does not fit in one message is split into fragments, sent in order. All the fragments of a record
+ * have the same seq, index counts up from 0 and is followed by up to (maximum message size - header) bytes of the
+ * record. A receiver drops a record on a gap in the index, a new seq or a total_len it cannot hold. */
+typedef struct {
+    uint8_t kind;           /* FRAGMENT_KIND_* */
+    uint8_t flags;          /* FRAGMENT_FIRST and/or FRAGMENT_LAST */
+    uint16_t seq;
+    uint16_t index;
+    uint16_t reserved;
+    uint32_t total_len;     /* Length of the whole record */
+} fragment_header_t;
+
+#define FRAGMENT_KIND_FEATURE 1
+#define FRAGMENT_KIND_EVENT 2
+
+#define FRAGMENT_FIRST (1 << 0)
+#define FRAGMENT_LAST (1 << 1)
+
+/* Record being reassembled */
+typedef struct {
+    uint8_t kind;           /* 0 when no record is in progress */
+    uint16_t seq;
+    uint16_t next_index;
+    uint32_t total_len;
+    uint32_t len;
+} reassembly_t;
+#endif /* CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION */
+
 static esp_amp_rpmsg_dev_t esp_amp_device = {0};
 static esp_amp_rpmsg_ept_t esp_amp_endpoint_feature = {0};
 static esp_amp_rpmsg_ept_t esp_amp_endpoint_event = {0};
+#if CONFIG_LOW_CODE_TRANSPORT_BATCH_UPDATES
+static esp_amp_rpmsg_ept_t esp_amp_endpoint_feature_batch = {0};
+#endif
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+static esp_amp_rpmsg_ept_t esp_amp_endpoint_fragment = {0};
+#endif
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+static esp_amp_rpmsg_ept_t esp_amp_endpoint_event_priority = {0};
+#endif
 
 static const char *TAG = "low_code_transport";
 
+typedef void (*rx_handler_t)(void *msg_data, uint16_t data_len);
+
+/* A received message which has been taken out of the rpmsg queue but not handled yet */
+typedef struct {
+    void *msg_data;
+    uint16_t data_len;
+    rx_handler_t handler;
+    uint32_t rx_tick;       /* mcycle when the message was taken out of the rpmsg queue, the system sends no timestamp */
+} rx_queue_item_t;
+
+/* esp_amp_rpmsg_poll() handles the messages of all the endpoints in arrival order. Received messages are sorted
+ * into an event queue and a feature queue instead, so that events are handled before feature updates which
+ * arrived earlier. */
+typedef struct {
+    rx_queue_item_t items[RX_QUEUE_LEN];
+    uint8_t head;
+    uint8_t count;
+} rx_queue_t;
+
+#if PENDING_QUEUE_LEN
+/* A feature update which could not be sent because no transmit buffer was available, with a copy of its value */
+typedef struct {
+    low_code_feature_data_t data;
+    uint8_t value[PENDING_VALUE_MAX_LEN];
+} pending_feature_t;
+#endif
+
+/* rx_cb_data of an endpoint */
+typedef struct {
+    rx_queue_t *queue;
+    rx_handler_t handler;
+    uint16_t addr;
+} rx_endpoint_t;
+
 static uint8_t buffer[BUF_SIZE];
 
-static int low_code_transport_event_to_system(low_code_event_t *event)
+static low_code_transport_stats_t transport_stats;
+#if STATS_DUMP_INTERVAL_MS
+static uint32_t stats_dump_last_ms = 0;
+#endif
+static low_code_transport_stats_cb_t stats_cb = NULL;
+
+/* Receive buffers held by the application. A batch hands every record in the same buffer to the application, so a
+ * buffer can be held several times and is destroyed on its last release. */
+typedef struct {
+    void *msg_data;
+    uint16_t refs;
+} rx_held_buffer_t;
+
+/* Receive buffer which is handed to the application in place, set only while it is being dispatched */
+static void *rx_message = NULL;
+static rx_held_buffer_t *rx_message_held = NULL;
+static rx_held_buffer_t rx_held_buffers[RX_QUEUE_LEN];
+
+/* Cleared when a poll finds the receive queue empty, set again by the next poll which handles a message or by the
+ * doorbell interrupt from the system */
+static volatile bool rx_pending = true;
+/* Set by the first doorbell interrupt: installing the handler does not mean that the system rings it */
+static volatile bool rx_doorbell_confirmed = false;
+
+static rx_queue_t rx_event_queue;
+static rx_queue_t rx_feature_queue;
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+/* Latency critical events, handled before anything else */
+static rx_queue_t rx_priority_queue;
+#endif
+
+#if PENDING_QUEUE_LEN
+static pending_feature_t pending_features[PENDING_QUEUE_LEN];
+static uint8_t pending_head = 0;
+static uint8_t pending_count = 0;
+#endif
+
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+static uint16_t tx_fragment_seq = 0;
+static reassembly_t reassembly;
+/* Aligned for the raw structures, the reassembled record is dispatched in place */
+alignas(8) static uint8_t reassembly_buffer[REASSEMBLY_BUF_SIZE];
+#endif
+
+/* Feature update being serialized in place, between low_code_feature_begin() and low_code_feature_commit() */
+static low_code_feature_data_t *tx_feature = NULL;
+static uint8_t *tx_feature_buffer = NULL;
+static int tx_feature_value_len = 0;
+
+/* rpmsg has no call to give back a transmit buffer which was not sent: a discarded one is kept here and handed
+ * out by the next tx_message_create() which fits in it */
+static void *tx_spare_buffer = NULL;
+static size_t tx_spare_size = 0;
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+static low_code_feature_data_t tx_feature_data;
+#endif
+
+static size_t feature_record_len(const low_code_feature_data_t *data)
 {
-    size_t buffer_size = sizeof(low_code_event_t) + event->event_data_size;
-    void *buffer = esp_amp_rpmsg_create_message(&esp_amp_device, buffer_size, ESP_AMP_RPMSG_DATA_DEFAULT);
-    if (buffer == NULL) {
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    return low_code_wire_feature_header_len(data) + data->value.value_len;
+#else
+    return sizeof(low_code_feature_data_t) + data->value.value_len;
+#endif
+}
+
+/* Serialize a feature update into a transmit buffer of at least feature_record_len() bytes */
+static size_t feature_record_write(const low_code_feature_data_t *data, uint8_t *record)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    size_t header_len = low_code_wire_feature_header_len(data);
+    low_code_wire_encode_feature_header(data, record, header_len);
+    memcpy(record + header_len, data->value.value, data->value.value_len);
+    transport_stats.tx_bytes_copied += data->value.value_len;
+    return header_len + data->value.value_len;
+#else
+    memcpy(record, data, sizeof(low_code_feature_data_t));
+    memcpy(record + sizeof(low_code_feature_data_t), data->value.value, data->value.value_len);
+    transport_stats.tx_bytes_copied += sizeof(low_code_feature_data_t) + data->value.value_len;
+    return sizeof(low_code_feature_data_t) + data->value.value_len;
+#endif
+}
+
+static size_t event_record_len(const low_code_event_t *event)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    return low_code_wire_event_header_len(event) + event->event_data_size;
+#else
+    return sizeof(low_code_event_t) + event->event_data_size;
+#endif
+}
+
+/* Serialize an event into a transmit buffer of at least event_record_len() bytes */
+static size_t event_record_write(const low_code_event_t *event, uint8_t *record)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    size_t header_len = low_code_wire_event_header_len(event);
+    low_code_wire_encode_event_header(event, record, header_len);
+    memcpy(record + header_len, event->event_data, event->event_data_size);
+    transport_stats.tx_bytes_copied += event->event_data_size;
+    return header_len + event->event_data_size;
+#else
+    memcpy(record, event, sizeof(low_code_event_t));
+    memcpy(record + sizeof(low_code_event_t), event->event_data, event->event_data_size);
+    transport_stats.tx_bytes_copied += sizeof(low_code_event_t) + event->event_data_size;
+    return sizeof(low_code_event_t) + event->event_data_size;
+#endif
+}
+
+/* Returns ESP_ERR_NO_MEM if no transmit buffer is available right now, ESP_ERR_INVALID_SIZE if the message can never
+ * be sent */
+static int tx_message_create(size_t buffer_size, void **buffer)
+{
+    if (tx_spare_buffer && buffer_size <= tx_spare_size) {
+        *buffer = tx_spare_buffer;
+        tx_spare_buffer = NULL;
+        return ESP_OK;
+    }
+    *buffer = esp_amp_rpmsg_create_message(&esp_amp_device, buffer_size, ESP_AMP_RPMSG_DATA_DEFAULT);
+    if (*buffer == NULL) {
+        if (buffer_size > esp_amp_rpmsg_get_max_size(&esp_amp_device)) {
+            transport_stats.tx_oversize_drops++;
+            printf("%s: message of %d bytes exceeds the maximum size\n", TAG, (int)buffer_size);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        transport_stats.tx_alloc_failures++;
         printf("%s: esp_amp_rpmsg_create_message failed\n", TAG);
         return ESP_ERR_NO_MEM;
     }
-    memcpy(buffer, event, sizeof(low_code_event_t));
-    memcpy((uint8_t*)buffer + sizeof(low_code_event_t), event->event_data, event->event_data_size);
-    int ret = esp_amp_rpmsg_send_nocopy(&esp_amp_device, &esp_amp_endpoint_event, ESP_AMP_ENDPOINT_EVENT, buffer, buffer_size);
+    return ESP_OK;
+}
+
+/* Give back a buffer from tx_message_create() without sending it */
+static void tx_message_discard(void *buffer, size_t buffer_size)
+{
+    if (tx_spare_buffer) {
+        /* Only happens if no message since the last discard fit in the spare, the rpmsg buffer is lost then */
+        printf("%s: transmit buffer spare already in use\n", TAG);
+        return;
+    }
+    tx_spare_buffer = buffer;
+    tx_spare_size = buffer_size;
+}
+
+static int tx_message_send(esp_amp_rpmsg_ept_t *endpoint, uint16_t dst_addr, void *buffer, size_t buffer_size)
+{
+    int ret = esp_amp_rpmsg_send_nocopy(&esp_amp_device, endpoint, dst_addr, buffer, buffer_size);
     if (ret != 0) {
+        transport_stats.tx_send_failures++;
         printf("%s: esp_amp_rpmsg_send_nocopy failed\n", TAG);
         return ESP_FAIL;
     }
+    transport_stats.tx_messages++;
+    transport_stats.tx_bytes += buffer_size;
+    if (dst_addr < LOW_CODE_TRANSPORT_ENDPOINT_MAX) {
+        transport_stats.endpoints[dst_addr].tx_messages++;
+        transport_stats.endpoints[dst_addr].tx_bytes += buffer_size;
+    }
     return ESP_OK;
 }
 
-static int low_code_transport_feature_update_to_system(low_code_feature_data_t *data)
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+/* Send a record, made of its serialized header followed by the payload, in fragments. The payload is copied into
+ * the messages from where it is, so no buffer for the whole record is needed. */
+static int tx_fragments_send(uint8_t kind, const uint8_t *header, size_t header_len, const uint8_t *payload, size_t payload_len)
 {
-    size_t buffer_size = sizeof(low_code_feature_data_t) + data->value.value_len;
-    void *buffer = esp_amp_rpmsg_create_message(&esp_amp_device, buffer_size, ESP_AMP_RPMSG_DATA_DEFAULT);
-    if (buffer == NULL) {
-        printf("%s: esp_amp_rpmsg_create_message failed\n", TAG);
+    size_t chunk_max = esp_amp_rpmsg_get_max_size(&esp_amp_device) - sizeof(fragment_header_t);
+    fragment_header_t fragment = {
+        .kind = kind,
+        .flags = FRAGMENT_FIRST,
+        .seq = tx_fragment_seq++,
+        .index = 0,
+        .reserved = 0,
+        .total_len = (uint32_t)(header_len + payload_len),
+    };
+
+    size_t offset = 0;
+    while (offset < fragment.total_len) {
+        size_t chunk_len = fragment.total_len - offset < chunk_max ? fragment.total_len - offset : chunk_max;
+        if (offset + chunk_len == fragment.total_len) {
+            fragment.flags |= FRAGMENT_LAST;
+        }
+        void *message;
+        int ret = tx_message_create(sizeof(fragment) + chunk_len, &message);
+        if (ret != ESP_OK) {
+            /* The fragments sent so far are dropped by the system when the next record starts */
+            return ret;
+        }
+        uint8_t *out = (uint8_t *)message;
+        memcpy(out, &fragment, sizeof(fragment));
+        out += sizeof(fragment);
+
+        /* The chunk starts in the header, the payload, or spans both */
+        size_t header_part = 0;
+        if (offset < header_len) {
+            header_part = header_len - offset < chunk_len ? header_len - offset : chunk_len;
+            memcpy(out, header + offset, header_part);
+        }
+        if (chunk_len > header_part) {
+            memcpy(out + header_part, payload + (offset + header_part - header_len), chunk_len - header_part);
+        }
+        transport_stats.tx_bytes_copied += chunk_len;
+
+        ret = tx_message_send(&esp_amp_endpoint_fragment, ESP_AMP_ENDPOINT_FRAGMENT, message, sizeof(fragment) + chunk_len);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        offset += chunk_len;
+        fragment.index++;
+        fragment.flags = 0;
+    }
+    transport_stats.tx_fragmented++;
+    return ESP_OK;
+}
+
+static int event_send_fragmented(const low_code_event_t *event)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    uint8_t header[LOW_CODE_WIRE_EVENT_HEADER_MAX_LEN];
+    size_t header_len = low_code_wire_event_header_len(event);
+    low_code_wire_encode_event_header(event, header, header_len);
+#else
+    const uint8_t *header = (const uint8_t *)event;
+    size_t header_len = sizeof(low_code_event_t);
+#endif
+    return tx_fragments_send(FRAGMENT_KIND_EVENT, header, header_len, (const uint8_t *)event->event_data, event->event_data_size);
+}
+
+static int feature_update_send_fragmented(const low_code_feature_data_t *data)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    uint8_t header[LOW_CODE_WIRE_FEATURE_HEADER_MAX_LEN];
+    size_t header_len = low_code_wire_feature_header_len(data);
+    low_code_wire_encode_feature_header(data, header, header_len);
+#else
+    const uint8_t *header = (const uint8_t *)data;
+    size_t header_len = sizeof(low_code_feature_data_t);
+#endif
+    return tx_fragments_send(FRAGMENT_KIND_FEATURE, header, header_len, data->value.value, data->value.value_len);
+}
+#endif /* CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION */
+
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+/* Events which the user is waiting for, or which must not be held up by feature traffic */
+static bool event_is_priority(low_code_event_type_t event_type)
+{
+    switch (event_type) {
+    case LOW_CODE_EVENT_FACTORY_RESET:
+    case LOW_CODE_EVENT_FORCED_ROLLBACK:
+    case LOW_CODE_EVENT_IDENTIFICATION_START:
+    case LOW_CODE_EVENT_IDENTIFICATION_STOP:
+    case LOW_CODE_EVENT_IDENTIFICATION_BLINK:
+    case LOW_CODE_EVENT_IDENTIFICATION_BREATHE:
+    case LOW_CODE_EVENT_IDENTIFICATION_OKAY:
+    case LOW_CODE_EVENT_IDENTIFICATION_CHANNEL_CHANGE:
+    case LOW_CODE_EVENT_IDENTIFICATION_FINISH_EFFECT:
+    case LOW_CODE_EVENT_IDENTIFICATION_STOP_EFFECT:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
+
+static int low_code_transport_event_to_system(low_code_event_t *event)
+{
+    size_t buffer_size = event_record_len(event);
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+    if (buffer_size > esp_amp_rpmsg_get_max_size(&esp_amp_device)) {
+        return event_send_fragmented(event);
+    }
+#endif
+    void *buffer;
+    int ret = tx_message_create(buffer_size, &buffer);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    event_record_write(event, (uint8_t*)buffer);
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    if (event_is_priority(event->event_type)) {
+        return tx_message_send(&esp_amp_endpoint_event_priority, ESP_AMP_ENDPOINT_EVENT_PRIORITY, buffer, buffer_size);
+    }
+#endif
+    return tx_message_send(&esp_amp_endpoint_event, ESP_AMP_ENDPOINT_EVENT, buffer, buffer_size);
+}
+
+static int feature_update_send(const low_code_feature_data_t *data)
+{
+    size_t buffer_size = feature_record_len(data);
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+    if (buffer_size > esp_amp_rpmsg_get_max_size(&esp_amp_device)) {
+        return feature_update_send_fragmented(data);
+    }
+#endif
+    void *buffer;
+    int ret = tx_message_create(buffer_size, &buffer);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    feature_record_write(data, (uint8_t*)buffer);
+    return tx_message_send(&esp_amp_endpoint_feature, ESP_AMP_ENDPOINT_FEATURE, buffer, buffer_size);
+}
+
+#if PENDING_QUEUE_LEN
+static void pending_pop()
+{
+    pending_head = (pending_head + 1) % PENDING_QUEUE_LEN;
+    pending_count--;
+}
+
+/* Keep a feature update to be sent by low_code_transport_flush_pending() */
+static int pending_push(const low_code_feature_data_t *data)
+{
+    if (data->value.value_len < 0 || data->value.value_len > PENDING_VALUE_MAX_LEN) {
+        transport_stats.tx_pending_dropped++;
+        printf("%s: feature value of %d bytes is too large to be kept for retrying\n", TAG, data->value.value_len);
         return ESP_ERR_NO_MEM;
     }
-    memcpy(buffer, data, sizeof(low_code_feature_data_t));
-    memcpy((uint8_t*)buffer + sizeof(low_code_feature_data_t), data->value.value, data->value.value_len);
-    int ret = esp_amp_rpmsg_send_nocopy(&esp_amp_device, &esp_amp_endpoint_feature, ESP_AMP_ENDPOINT_FEATURE, buffer, buffer_size);
-    if (ret != 0) {
-        printf("%s: esp_amp_rpmsg_send_nocopy failed\n", TAG);
-        return ESP_FAIL;
+
+    pending_feature_t *pending = NULL;
+#if CONFIG_LOW_CODE_TRANSPORT_PENDING_COALESCE
+    /* Only the latest value of a feature matters, replace the one which is waiting */
+    for (int i = 0; i < pending_count; i++) {
+        pending_feature_t *entry = &pending_features[(pending_head + i) % PENDING_QUEUE_LEN];
+        if (entry->data.details.endpoint_id == data->details.endpoint_id && entry->data.details.feature_id == data->details.feature_id) {
+            pending = entry;
+            transport_stats.tx_pending_coalesced++;
+            break;
+        }
+    }
+#endif
+    if (!pending) {
+        if (pending_count == PENDING_QUEUE_LEN) {
+            transport_stats.tx_pending_dropped++;
+#if CONFIG_LOW_CODE_TRANSPORT_PENDING_DROP_NEWEST
+            printf("%s: pending queue full, dropping feature update\n", TAG);
+            return ESP_ERR_NO_MEM;
+#else
+            printf("%s: pending queue full, dropping the oldest feature update\n", TAG);
+            pending_pop();
+#endif
+        }
+        pending = &pending_features[(pending_head + pending_count) % PENDING_QUEUE_LEN];
+        pending_count++;
+        transport_stats.tx_pending_queued++;
     }
+
+    pending->data = *data;
+    memcpy(pending->value, data->value.value, data->value.value_len);
+    pending->data.value.value = pending->value;
     return ESP_OK;
 }
+#endif /* PENDING_QUEUE_LEN */
 
-static int from_system_event_cb(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data) {
-    low_code_event_t event;
-    memcpy(&event, msg_data, sizeof(low_code_event_t));
-    if (event.event_data_size > BUF_SIZE) {
-        printf("%s: event daata exceeds the buffer size of: %d\n", TAG, BUF_SIZE);
-        return 0;
+static int low_code_transport_feature_update_to_system(low_code_feature_data_t *data)
+{
+#if PENDING_QUEUE_LEN
+    /* Updates which are waiting go first, so that a feature always ends up with its latest value */
+    low_code_transport_flush_pending();
+    if (pending_count) {
+        return pending_push(data);
     }
-    event.event_data = buffer;
-    memcpy(event.event_data, (uint8_t*)msg_data + sizeof(low_code_event_t), event.event_data_size);
-    low_code_event_from_transport(&event);
-    esp_amp_rpmsg_destroy(&esp_amp_device, msg_data);
-    return 0;
+    int ret = feature_update_send(data);
+    if (ret == ESP_ERR_NO_MEM) {
+        return pending_push(data);
+    }
+    return ret;
+#else
+    return feature_update_send(data);
+#endif
 }
 
-static int from_system_data_cb(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data) {
-    low_code_feature_data_t data;
-    memcpy(&data, msg_data, sizeof(low_code_feature_data_t));
-    if (data.value.value_len > BUF_SIZE) {
+static low_code_feature_data_t *low_code_transport_feature_begin(int value_len)
+{
+    if (tx_feature) {
+        printf("%s: feature update already in progress\n", TAG);
+        return NULL;
+    }
+
+    /* The value is placed right after space for the largest header, the header is written on commit */
+    size_t buffer_size = FEATURE_BEGIN_HEADER_LEN + value_len;
+    void *message;
+    if (tx_message_create(buffer_size, &message) != ESP_OK) {
+        return NULL;
+    }
+    uint8_t *buffer = (uint8_t *)message;
+
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    tx_feature = &tx_feature_data;
+#else
+    /* The raw structure is the header, the application fills it in place */
+    tx_feature = (low_code_feature_data_t *)buffer;
+#endif
+    tx_feature_buffer = buffer;
+    tx_feature_value_len = value_len;
+    memset(tx_feature, 0, sizeof(low_code_feature_data_t));
+    tx_feature->value.value_len = value_len;
+    tx_feature->value.value = buffer + FEATURE_BEGIN_HEADER_LEN;
+    return tx_feature;
+}
+
+static int low_code_transport_feature_commit(low_code_feature_data_t *data)
+{
+    if (!tx_feature || data != tx_feature) {
+        printf("%s: feature update was not started with low_code_feature_begin()\n", TAG);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (data->value.value_len < 0 || data->value.value_len > tx_feature_value_len) {
+        printf("%s: value_len %d exceeds the allocated length %d\n", TAG, data->value.value_len, tx_feature_value_len);
+        tx_message_discard(tx_feature_buffer, FEATURE_BEGIN_HEADER_LEN + tx_feature_value_len);
+        tx_feature = NULL;
+        tx_feature_buffer = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    low_code_wire_encode_feature_header(data, tx_feature_buffer, FEATURE_BEGIN_HEADER_LEN);
+#endif
+    size_t buffer_size = FEATURE_BEGIN_HEADER_LEN + data->value.value_len;
+    uint8_t *buffer = tx_feature_buffer;
+    tx_feature = NULL;
+    tx_feature_buffer = NULL;
+    return tx_message_send(&esp_amp_endpoint_feature, ESP_AMP_ENDPOINT_FEATURE, buffer, buffer_size);
+}
+
+static inline bool rx_in_place(const void *data, size_t align)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_ZERO_COPY_RX
+    return ((uintptr_t)data & (align - 1)) == 0;
+#else
+    return false;
+#endif
+}
+
+static void rx_message_begin(void *msg_data, size_t align)
+{
+    transport_stats.rx_messages++;
+    rx_message = rx_in_place(msg_data, align) ? msg_data : NULL;
+    rx_message_held = NULL;
+}
+
+static void rx_message_end(void *msg_data)
+{
+    /* The application may keep the buffer with low_code_hold_rx_buffer(), it is destroyed on release then */
+    if (!rx_message_held) {
+        esp_amp_rpmsg_destroy(&esp_amp_device, msg_data);
+    }
+    rx_message = NULL;
+    rx_message_held = NULL;
+}
+
+static void *low_code_transport_hold_rx_buffer()
+{
+    if (!rx_message) {
+        return NULL;
+    }
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+    /* The reassembly buffer is reused by the next record, it cannot be held */
+    if (rx_message == reassembly_buffer) {
+        return NULL;
+    }
+#endif
+    if (!rx_message_held) {
+        for (int i = 0; i < RX_QUEUE_LEN; i++) {
+            if (!rx_held_buffers[i].msg_data) {
+                rx_message_held = &rx_held_buffers[i];
+                rx_message_held->msg_data = rx_message;
+                rx_message_held->refs = 0;
+                break;
+            }
+        }
+        if (!rx_message_held) {
+            printf("%s: too many held receive buffers\n", TAG);
+            return NULL;
+        }
+    }
+    rx_message_held->refs++;
+    return rx_message;
+}
+
+static int low_code_transport_release_rx_buffer(void *handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    rx_held_buffer_t *held = NULL;
+    for (int i = 0; i < RX_QUEUE_LEN; i++) {
+        if (rx_held_buffers[i].msg_data == handle) {
+            held = &rx_held_buffers[i];
+            break;
+        }
+    }
+    if (!held) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (--held->refs > 0) {
+        return ESP_OK;
+    }
+    held->msg_data = NULL;
+    if (held == rx_message_held) {
+        /* Released while it is still being dispatched, it is destroyed once the dispatch is done */
+        rx_message_held = NULL;
+    } else {
+        esp_amp_rpmsg_destroy(&esp_amp_device, handle);
+    }
+    return ESP_OK;
+}
+
+/* Deserialize a feature record of a received message. The returned feature data either points into the
+ * message (zero copy) or is `scratch` with the value copied into the static buffer.
+ * Returns NULL if the record is malformed, else *record_len is set to the length of the record. */
+static low_code_feature_data_t *feature_record_read(uint8_t *record, size_t len, low_code_feature_data_t *scratch, size_t *record_len)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    *record_len = low_code_wire_decode_feature(record, len, scratch);
+    if (*record_len == 0) {
+        printf("%s: invalid feature record, len: %d\n", TAG, (int)len);
+        return NULL;
+    }
+    if (rx_message) {
+        return scratch;
+    }
+    if (scratch->value.value_len > BUF_SIZE) {
+        transport_stats.rx_oversize_drops++;
+        printf("%s: feature data value_len exceeds the buffer size of: %d\n", TAG, BUF_SIZE);
+        return NULL;
+    }
+    memcpy(buffer, scratch->value.value, scratch->value.value_len);
+    scratch->value.value = buffer;
+    transport_stats.rx_bytes_copied += scratch->value.value_len;
+    return scratch;
+#else
+    if (len < sizeof(low_code_feature_data_t)) {
+        printf("%s: feature data truncated, len: %d\n", TAG, (int)len);
+        return NULL;
+    }
+
+    if (rx_message) {
+        /* Zero copy: only the value pointer is patched to point to the value in the message */
+        low_code_feature_data_t *data = (low_code_feature_data_t *)record;
+        if (data->value.value_len < 0 || sizeof(low_code_feature_data_t) + data->value.value_len > len) {
+            printf("%s: feature data has invalid value_len: %d\n", TAG, data->value.value_len);
+            return NULL;
+        }
+        data->value.value = record + sizeof(low_code_feature_data_t);
+        *record_len = sizeof(low_code_feature_data_t) + data->value.value_len;
+        return data;
+    }
+
+    memcpy(scratch, record, sizeof(low_code_feature_data_t));
+    if (scratch->value.value_len < 0 || scratch->value.value_len > BUF_SIZE || sizeof(low_code_feature_data_t) + scratch->value.value_len > len) {
+        if (scratch->value.value_len > BUF_SIZE) {
+            transport_stats.rx_oversize_drops++;
+        }
         printf("%s: feature data value_len exceeds the buffer size of: %d\n", TAG, BUF_SIZE);
-        return 0;
+        return NULL;
+    }
+    scratch->value.value = buffer;
+    memcpy(scratch->value.value, record + sizeof(low_code_feature_data_t), scratch->value.value_len);
+    transport_stats.rx_bytes_copied += sizeof(low_code_feature_data_t) + scratch->value.value_len;
+    *record_len = sizeof(low_code_feature_data_t) + scratch->value.value_len;
+    return scratch;
+#endif
+}
+
+/* Same as feature_record_read(), for events */
+static low_code_event_t *event_record_read(uint8_t *record, size_t len, low_code_event_t *scratch, size_t *record_len)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT
+    *record_len = low_code_wire_decode_event(record, len, scratch);
+    if (*record_len == 0) {
+        printf("%s: invalid event record, len: %d\n", TAG, (int)len);
+        return NULL;
+    }
+    if (rx_message) {
+        return scratch;
+    }
+    if (scratch->event_data_size > BUF_SIZE) {
+        transport_stats.rx_oversize_drops++;
+        printf("%s: event daata exceeds the buffer size of: %d\n", TAG, BUF_SIZE);
+        return NULL;
+    }
+    memcpy(buffer, scratch->event_data, scratch->event_data_size);
+    scratch->event_data = buffer;
+    transport_stats.rx_bytes_copied += scratch->event_data_size;
+    return scratch;
+#else
+    if (len < sizeof(low_code_event_t)) {
+        printf("%s: event truncated, len: %d\n", TAG, (int)len);
+        return NULL;
+    }
+
+    if (rx_message) {
+        /* Zero copy: only the event data pointer is patched to point to the data in the message */
+        low_code_event_t *event = (low_code_event_t *)record;
+        if (event->event_data_size < 0 || sizeof(low_code_event_t) + event->event_data_size > len) {
+            printf("%s: event has invalid event_data_size: %d\n", TAG, event->event_data_size);
+            return NULL;
+        }
+        event->event_data = record + sizeof(low_code_event_t);
+        *record_len = sizeof(low_code_event_t) + event->event_data_size;
+        return event;
+    }
+
+    memcpy(scratch, record, sizeof(low_code_event_t));
+    if (scratch->event_data_size < 0 || scratch->event_data_size > BUF_SIZE || sizeof(low_code_event_t) + scratch->event_data_size > len) {
+        if (scratch->event_data_size > BUF_SIZE) {
+            transport_stats.rx_oversize_drops++;
+        }
+        printf("%s: event daata exceeds the buffer size of: %d\n", TAG, BUF_SIZE);
+        return NULL;
+    }
+    scratch->event_data = buffer;
+    memcpy(scratch->event_data, record + sizeof(low_code_event_t), scratch->event_data_size);
+    transport_stats.rx_bytes_copied += sizeof(low_code_event_t) + scratch->event_data_size;
+    *record_len = sizeof(low_code_event_t) + scratch->event_data_size;
+    return scratch;
+#endif
+}
+
+#if CONFIG_LOW_CODE_TRANSPORT_BATCH_UPDATES
+#if PENDING_QUEUE_LEN
+static int pending_push_batch(const low_code_feature_data_t *data, int count)
+{
+    int ret = ESP_OK;
+    for (int i = 0; i < count; i++) {
+        int err = pending_push(&data[i]);
+        if (err != ESP_OK) {
+            ret = err;
+        }
     }
-    data.value.value = buffer;
-    memcpy(data.value.value, (uint8_t*)msg_data + sizeof(low_code_feature_data_t), data.value.value_len);
-    low_code_feature_update_from_transport(&data);
+    return ret;
+}
+#endif
+
+static int low_code_transport_feature_update_batch_to_system(low_code_feature_data_t *data, int count)
+{
+    size_t max_size = esp_amp_rpmsg_get_max_size(&esp_amp_device);
+    int start = 0;
+
+#if PENDING_QUEUE_LEN
+    low_code_transport_flush_pending();
+    if (pending_count) {
+        return pending_push_batch(data, count);
+    }
+#endif
+
+    while (start < count) {
+        /* Pack as many records as fit in one message. A record which does not fit on its own fails below. */
+        size_t buffer_size = BATCH_RECORD_ALIGN(sizeof(feature_batch_header_t)) + BATCH_RECORD_ALIGN(feature_record_len(&data[start]));
+        int end = start + 1;
+        while (end < count && buffer_size + BATCH_RECORD_ALIGN(feature_record_len(&data[end])) <= max_size) {
+            buffer_size += BATCH_RECORD_ALIGN(feature_record_len(&data[end]));
+            end++;
+        }
+
+        void *message;
+        int ret = tx_message_create(buffer_size, &message);
+#if PENDING_QUEUE_LEN
+        if (ret == ESP_ERR_NO_MEM) {
+            /* Keep the remaining updates to be sent one by one */
+            return pending_push_batch(&data[start], count - start);
+        }
+#endif
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        uint8_t *buffer = (uint8_t *)message;
+
+        feature_batch_header_t header = {
+            .count = (uint16_t)(end - start),
+            .reserved = 0,
+        };
+        memcpy(buffer, &header, sizeof(header));
+        size_t offset = BATCH_RECORD_ALIGN(sizeof(header));
+        for (int i = start; i < end; i++) {
+            size_t record_len = feature_record_write(&data[i], buffer + offset);
+            memset(buffer + offset + record_len, 0, BATCH_RECORD_ALIGN(record_len) - record_len);
+            offset += BATCH_RECORD_ALIGN(record_len);
+        }
+
+        ret = tx_message_send(&esp_amp_endpoint_feature_batch, ESP_AMP_ENDPOINT_FEATURE_BATCH, buffer, buffer_size);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        start = end;
+    }
+    return ESP_OK;
+}
+
+static void rx_handle_feature_batch(void *msg_data, uint16_t data_len)
+{
+    transport_stats.rx_bytes += data_len;
+    if (data_len < sizeof(feature_batch_header_t)) {
+        transport_stats.rx_dropped++;
+        printf("%s: feature batch too short, len: %d\n", TAG, data_len);
+        esp_amp_rpmsg_destroy(&esp_amp_device, msg_data);
+        return;
+    }
+    feature_batch_header_t header;
+    memcpy(&header, msg_data, sizeof(feature_batch_header_t));
+    rx_message_begin(msg_data, FEATURE_RECORD_ALIGN);
+
+    size_t offset = BATCH_RECORD_ALIGN(sizeof(feature_batch_header_t));
+    for (int i = 0; i < header.count && offset < data_len; i++) {
+        low_code_feature_data_t scratch;
+        size_t record_len;
+        low_code_feature_data_t *data = feature_record_read((uint8_t*)msg_data + offset, data_len - offset, &scratch, &record_len);
+        if (!data) {
+            transport_stats.rx_dropped++;
+            printf("%s: feature batch record %d is invalid\n", TAG, i);
+            break;
+        }
+        low_code_feature_update_from_transport(data);
+        offset += BATCH_RECORD_ALIGN(record_len);
+    }
+    rx_message_end(msg_data);
+}
+#endif /* CONFIG_LOW_CODE_TRANSPORT_BATCH_UPDATES */
+
+static void rx_handle_event(void *msg_data, uint16_t data_len)
+{
+    transport_stats.rx_bytes += data_len;
+    rx_message_begin(msg_data, EVENT_RECORD_ALIGN);
+
+    low_code_event_t scratch;
+    size_t record_len;
+    low_code_event_t *event = event_record_read((uint8_t*)msg_data, data_len, &scratch, &record_len);
+    if (event) {
+        low_code_event_from_transport(event);
+    } else {
+        transport_stats.rx_dropped++;
+    }
+    rx_message_end(msg_data);
+}
+
+static void rx_handle_feature(void *msg_data, uint16_t data_len)
+{
+    transport_stats.rx_bytes += data_len;
+    rx_message_begin(msg_data, FEATURE_RECORD_ALIGN);
+
+    low_code_feature_data_t scratch;
+    size_t record_len;
+    low_code_feature_data_t *data = feature_record_read((uint8_t*)msg_data, data_len, &scratch, &record_len);
+    if (data) {
+        low_code_feature_update_from_transport(data);
+    } else {
+        transport_stats.rx_dropped++;
+    }
+    rx_message_end(msg_data);
+}
+
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+static void reassembly_drop(const char *reason)
+{
+    transport_stats.rx_fragment_drops++;
+    printf("%s: dropping fragmented record: %s\n", TAG, reason);
+    reassembly.kind = 0;
+}
+
+/* Dispatch the reassembled record in place, like a zero copy receive buffer */
+static void reassembly_dispatch()
+{
+    uint8_t kind = reassembly.kind;
+    reassembly.kind = 0;
+    transport_stats.rx_reassembled++;
+    rx_message = reassembly_buffer;
+    rx_message_held = NULL;
+
+    size_t record_len;
+    if (kind == FRAGMENT_KIND_EVENT) {
+        low_code_event_t scratch;
+        low_code_event_t *event = event_record_read(reassembly_buffer, reassembly.len, &scratch, &record_len);
+        if (event) {
+            low_code_event_from_transport(event);
+        } else {
+            transport_stats.rx_dropped++;
+        }
+    } else {
+        low_code_feature_data_t scratch;
+        low_code_feature_data_t *data = feature_record_read(reassembly_buffer, reassembly.len, &scratch, &record_len);
+        if (data) {
+            low_code_feature_update_from_transport(data);
+        } else {
+            transport_stats.rx_dropped++;
+        }
+    }
+    rx_message = NULL;
+}
+
+static void rx_handle_fragment(void *msg_data, uint16_t data_len)
+{
+    transport_stats.rx_bytes += data_len;
+    transport_stats.rx_messages++;
+
+    fragment_header_t fragment;
+    if (data_len < sizeof(fragment)) {
+        transport_stats.rx_dropped++;
+        printf("%s: fragment truncated, len: %d\n", TAG, data_len);
+        esp_amp_rpmsg_destroy(&esp_amp_device, msg_data);
+        return;
+    }
+    memcpy(&fragment, msg_data, sizeof(fragment));
+    const uint8_t *chunk = (const uint8_t *)msg_data + sizeof(fragment);
+    size_t chunk_len = data_len - sizeof(fragment);
+
+    if (fragment.flags & FRAGMENT_FIRST) {
+        if (reassembly.kind) {
+            reassembly_drop("incomplete");
+        }
+        if (fragment.total_len > REASSEMBLY_BUF_SIZE) {
+            transport_stats.rx_oversize_drops++;
+            reassembly_drop("exceeds the reassembly buffer");
+        } else {
+            reassembly.kind = fragment.kind;
+            reassembly.seq = fragment.seq;
+            reassembly.next_index = 0;
+            reassembly.total_len = fragment.total_len;
+            reassembly.len = 0;
+        }
+    }
+
+    if (reassembly.kind) {
+        if (fragment.seq != reassembly.seq || fragment.index != reassembly.next_index) {
+            reassembly_drop("missing fragment");
+        } else if (reassembly.len + chunk_len > reassembly.total_len) {
+            reassembly_drop("longer than total_len");
+        } else {
+            memcpy(reassembly_buffer + reassembly.len, chunk, chunk_len);
+            transport_stats.rx_bytes_copied += chunk_len;
+            reassembly.len += chunk_len;
+            reassembly.next_index++;
+        }
+    }
+    /* The fragment is copied, free its buffer for the system before dispatching */
     esp_amp_rpmsg_destroy(&esp_amp_device, msg_data);
+
+    if (reassembly.kind && (fragment.flags & FRAGMENT_LAST)) {
+        if (reassembly.len != reassembly.total_len) {
+            reassembly_drop("shorter than total_len");
+        } else {
+            reassembly_dispatch();
+        }
+    }
+}
+#endif /* CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION */
+
+static rx_endpoint_t rx_endpoint_event = {&rx_event_queue, rx_handle_event, ESP_AMP_ENDPOINT_EVENT};
+static rx_endpoint_t rx_endpoint_feature = {&rx_feature_queue, rx_handle_feature, ESP_AMP_ENDPOINT_FEATURE};
+#if CONFIG_LOW_CODE_TRANSPORT_BATCH_UPDATES
+static rx_endpoint_t rx_endpoint_feature_batch = {&rx_feature_queue, rx_handle_feature_batch, ESP_AMP_ENDPOINT_FEATURE_BATCH};
+#endif
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+static rx_endpoint_t rx_endpoint_event_priority = {&rx_priority_queue, rx_handle_event, ESP_AMP_ENDPOINT_EVENT_PRIORITY};
+#endif
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+/* Fragments of events are queued with the feature updates as well, fragments must be handled in order */
+static rx_endpoint_t rx_endpoint_fragment = {&rx_feature_queue, rx_handle_fragment, ESP_AMP_ENDPOINT_FRAGMENT};
+#endif
+
+static int from_system_cb(void* msg_data, uint16_t data_len, uint16_t src_addr, void* rx_cb_data) {
+    rx_endpoint_t *endpoint = (rx_endpoint_t *)rx_cb_data;
+    rx_queue_t *queue = endpoint->queue;
+
+    /* rx_fill() only polls while there is space in both the queues */
+    rx_queue_item_t *item = &queue->items[(queue->head + queue->count) % RX_QUEUE_LEN];
+    item->msg_data = msg_data;
+    item->data_len = data_len;
+    item->handler = endpoint->handler;
+    item->rx_tick = RV_READ_CSR(mcycle);
+    queue->count++;
+
+    transport_stats.endpoints[endpoint->addr].rx_messages++;
+    transport_stats.endpoints[endpoint->addr].rx_bytes += data_len;
+    uint8_t *high_water_mark = queue == &rx_feature_queue ? &transport_stats.rx_feature_queue_hwm : &transport_stats.rx_event_queue_hwm;
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    if (queue == &rx_priority_queue) {
+        high_water_mark = &transport_stats.rx_priority_queue_hwm;
+    }
+#endif
+    if (queue->count > *high_water_mark) {
+        *high_water_mark = queue->count;
+    }
     return 0;
 }
 
+static int rx_doorbell_isr(void *arg)
+{
+    rx_pending = true;
+    rx_doorbell_confirmed = true;
+    return 0;
+}
+
+static inline bool rx_queues_have_space()
+{
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    if (rx_priority_queue.count >= RX_QUEUE_LEN) {
+        return false;
+    }
+#endif
+    return rx_event_queue.count < RX_QUEUE_LEN && rx_feature_queue.count < RX_QUEUE_LEN;
+}
+
+/* Move received messages from the rpmsg queue into the event and feature queues */
+static void rx_fill()
+{
+    /* Clear before polling, so that a doorbell which arrives while polling is not lost */
+    rx_pending = false;
+    while (rx_queues_have_space()) {
+        if (esp_amp_rpmsg_poll(&esp_amp_device) != 0) {
+            return;
+        }
+    }
+    /* Stopped on a full queue, more messages may be waiting */
+    rx_pending = true;
+}
+
+static void rx_latency_record(uint32_t cycles)
+{
+    int bucket = 0;
+    while (bucket < LOW_CODE_TRANSPORT_LATENCY_BUCKETS - 1 && cycles >= ((uint32_t)LATENCY_BUCKET_0_CYCLES << bucket)) {
+        bucket++;
+    }
+    transport_stats.rx_latency_hist[bucket]++;
+}
+
+/* Handle up to `budget` messages of the queue. Returns the number of messages handled. */
+static int rx_drain(rx_queue_t *queue, int budget)
+{
+    int handled = 0;
+    while (handled < budget && queue->count > 0) {
+        rx_queue_item_t item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % RX_QUEUE_LEN;
+        queue->count--;
+        rx_latency_record(RV_READ_CSR(mcycle) - item.rx_tick);
+        item.handler(item.msg_data, item.data_len);
+        handled++;
+    }
+    return handled;
+}
+
+/* Handle the waiting priority events, then the waiting events */
+static void rx_drain_events(int budget)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    rx_drain(&rx_priority_queue, RX_QUEUE_LEN);
+#endif
+    rx_drain(&rx_event_queue, budget);
+}
+
 static int low_code_transport_init(void)
 {
     int ret;
@@ -115,8 +1152,22 @@ static int low_code_transport_init(void)
         return ret;
     }
 
-    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_EVENT, from_system_event_cb, NULL, &esp_amp_endpoint_event);
-    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_FEATURE, from_system_data_cb, NULL, &esp_amp_endpoint_feature);
+    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_EVENT, from_system_cb, &rx_endpoint_event, &esp_amp_endpoint_event);
+    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_FEATURE, from_system_cb, &rx_endpoint_feature, &esp_amp_endpoint_feature);
+#if CONFIG_LOW_CODE_TRANSPORT_BATCH_UPDATES
+    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_FEATURE_BATCH, from_system_cb, &rx_endpoint_feature_batch, &esp_amp_endpoint_feature_batch);
+#endif
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_EVENT_PRIORITY, from_system_cb, &rx_endpoint_event_priority, &esp_amp_endpoint_event_priority);
+#endif
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+    esp_amp_rpmsg_create_endpoint(&esp_amp_device, ESP_AMP_ENDPOINT_FRAGMENT, from_system_cb, &rx_endpoint_fragment, &esp_amp_endpoint_fragment);
+#endif
+
+    /* Not fatal: without the doorbell, rx_pending is only updated by polling */
+    if (esp_amp_sw_intr_add_handler(SW_INTR_ID_VQ_MSG, rx_doorbell_isr, NULL) != 0) {
+        printf("%s: Failed to add rx doorbell handler\n", TAG);
+    }
 
     esp_amp_event_notify(ESP_AMP_EVENT_SUBCORE_READY);
 
@@ -125,15 +1176,33 @@ static int low_code_transport_init(void)
 
 static int low_code_transport_get_event_from_system()
 {
-    // TODO: call the API which polls for particular endpoint only
-    esp_amp_rpmsg_poll(&esp_amp_device);
+    rx_fill();
+    rx_drain_events(EVENT_POLL_BUDGET);
+
+#if STATS_DUMP_INTERVAL_MS
+    uint32_t now = esp_amp_platform_get_time_ms();
+    if (now - stats_dump_last_ms >= STATS_DUMP_INTERVAL_MS) {
+        stats_dump_last_ms = now;
+        if (stats_cb) {
+            stats_cb(&transport_stats);
+        } else {
+            low_code_transport_dump_stats();
+        }
+    }
+#endif
     return ESP_OK;
 }
 
 static int low_code_transport_get_feature_update_from_system()
 {
-    // TODO: call the API which polls for particular endpoint only
-    esp_amp_rpmsg_poll(&esp_amp_device);
+    for (int i = 0; i < FEATURE_POLL_BUDGET; i++) {
+        rx_fill();
+        /* Events have strict priority, a feature update is only handled when no event is waiting */
+        rx_drain_events(RX_QUEUE_LEN);
+        if (rx_drain(&rx_feature_queue, 1) == 0) {
+            break;
+        }
+    }
     return ESP_OK;
 }
 
@@ -150,7 +1219,17 @@ int low_code_transport_register_callbacks()
         .event_cb = low_code_transport_event_to_system,
         .feature_update_cb = low_code_transport_feature_update_to_system,
         .get_event = low_code_transport_get_event_from_system,
-        .get_feature_update = low_code_transport_get_feature_update_from_system
+        .get_feature_update = low_code_transport_get_feature_update_from_system,
+#if CONFIG_LOW_CODE_TRANSPORT_BATCH_UPDATES
+        .feature_update_batch_cb = low_code_transport_feature_update_batch_to_system,
+#else
+        .feature_update_batch_cb = NULL,
+#endif
+        .hold_rx_buffer = low_code_transport_hold_rx_buffer,
+        .release_rx_buffer = low_code_transport_release_rx_buffer,
+        .feature_begin = low_code_transport_feature_begin,
+        .feature_commit = low_code_transport_feature_commit,
+        .get_time_ms = esp_amp_platform_get_time_ms,
     };
     ret = low_code_register_transport_callbacks(&callbacks_list);
     if (ret != ESP_OK) {
@@ -158,3 +1237,88 @@ int low_code_transport_register_callbacks()
     }
     return ret;
 }
+
+int low_code_transport_get_stats(low_code_transport_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = transport_stats;
+    return ESP_OK;
+}
+
+void low_code_transport_reset_stats(void)
+{
+    memset(&transport_stats, 0, sizeof(transport_stats));
+}
+
+bool low_code_transport_rx_pending(void)
+{
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    if (rx_priority_queue.count > 0) {
+        return true;
+    }
+#endif
+    return rx_pending || rx_event_queue.count > 0 || rx_feature_queue.count > 0;
+}
+
+bool low_code_transport_rx_doorbell_confirmed(void)
+{
+    return rx_doorbell_confirmed;
+}
+
+bool low_code_transport_tx_pending(void)
+{
+#if PENDING_QUEUE_LEN
+    return pending_count > 0;
+#else
+    return false;
+#endif
+}
+
+void low_code_transport_set_stats_callback(low_code_transport_stats_cb_t cb)
+{
+    stats_cb = cb;
+}
+
+void low_code_transport_dump_stats(void)
+{
+    low_code_transport_stats_t *stats = &transport_stats;
+    printf("%s: rx: %" PRIu32 " msgs %" PRIu32 " bytes, %" PRIu32 " copied, %" PRIu32 " dropped, %" PRIu32 " oversize, queue hwm: priority %u event %u feature %u\n", TAG,
+           stats->rx_messages, stats->rx_bytes, stats->rx_bytes_copied, stats->rx_dropped, stats->rx_oversize_drops,
+           stats->rx_priority_queue_hwm, stats->rx_event_queue_hwm, stats->rx_feature_queue_hwm);
+    printf("%s: tx: %" PRIu32 " msgs %" PRIu32 " bytes, %" PRIu32 " copied, %" PRIu32 " alloc failures, %" PRIu32 " oversize, %" PRIu32 " send failures\n", TAG,
+           stats->tx_messages, stats->tx_bytes, stats->tx_bytes_copied, stats->tx_alloc_failures, stats->tx_oversize_drops,
+           stats->tx_send_failures);
+    printf("%s: fragments: %" PRIu32 " records sent, %" PRIu32 " reassembled, %" PRIu32 " dropped\n", TAG,
+           stats->tx_fragmented, stats->rx_reassembled, stats->rx_fragment_drops);
+    for (int i = 0; i < LOW_CODE_TRANSPORT_ENDPOINT_MAX; i++) {
+        low_code_transport_endpoint_stats_t *endpoint = &stats->endpoints[i];
+        printf("%s: endpoint %d: rx %" PRIu32 " msgs %" PRIu32 " bytes, tx %" PRIu32 " msgs %" PRIu32 " bytes\n", TAG, i,
+               endpoint->rx_messages, endpoint->rx_bytes, endpoint->tx_messages, endpoint->tx_bytes);
+    }
+    printf("%s: rx latency (cycles):", TAG);
+    for (int i = 0; i < LOW_CODE_TRANSPORT_LATENCY_BUCKETS; i++) {
+        if (i < LOW_CODE_TRANSPORT_LATENCY_BUCKETS - 1) {
+            printf(" <%" PRIu32 ": %" PRIu32, (uint32_t)LATENCY_BUCKET_0_CYCLES << i, stats->rx_latency_hist[i]);
+        } else {
+            printf(" more: %" PRIu32, stats->rx_latency_hist[i]);
+        }
+    }
+    printf("\n");
+}
+
+void low_code_transport_flush_pending(void)
+{
+#if PENDING_QUEUE_LEN
+    while (pending_count) {
+        int ret = feature_update_send(&pending_features[pending_head].data);
+        if (ret == ESP_ERR_NO_MEM) {
+            /* Still no transmit buffer, try again later */
+            return;
+        }
+        /* Sent, or failed in a way which retrying does not fix */
+        pending_pop();
+    }
+#endif
+}
@@ -24,11 +24,73 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Number of endpoints with statistics
+ *
+ * 0 feature updates, 1 events, 2 batched feature updates, 3 fragments, 4 priority events
+ */
+#define LOW_CODE_TRANSPORT_ENDPOINT_MAX 5
+
+/**
+ * @brief Number of buckets of the receive latency histogram
+ *
+ * Bucket i counts latencies below (256 << i) LP core cycles (16 us << i at 16 MHz), the last bucket counts
+ * all the longer ones. The system does not timestamp its messages, so this is the local dispatch latency only:
+ * from the poll which takes a message out of the rpmsg queue to its callback. The time the message waited in
+ * the rpmsg queue before that poll is not included.
+ */
+#define LOW_CODE_TRANSPORT_LATENCY_BUCKETS 8
+
+/**
+ * @brief Statistics of a transport endpoint
+ */
+typedef struct {
+    uint32_t rx_messages;       /*!< Messages received on the endpoint */
+    uint32_t rx_bytes;          /*!< Bytes received on the endpoint */
+    uint32_t tx_messages;       /*!< Messages sent to the endpoint */
+    uint32_t tx_bytes;          /*!< Bytes sent to the endpoint */
+} low_code_transport_endpoint_stats_t;
+
+/**
+ * @brief Transport statistics
+ */
+typedef struct {
+    uint32_t rx_messages;       /*!< Messages received from the system */
+    uint32_t rx_bytes;          /*!< Bytes received from the system */
+    uint32_t rx_bytes_copied;   /*!< Bytes copied out of the receive buffers before dispatching */
+    uint32_t rx_dropped;        /*!< Received messages or batch records dropped as invalid */
+    uint32_t rx_oversize_drops; /*!< Received values dropped because they exceed the copy buffer */
+    uint32_t tx_messages;       /*!< Messages sent to the system */
+    uint32_t tx_bytes;          /*!< Bytes sent to the system */
+    uint32_t tx_bytes_copied;   /*!< Bytes copied into the transmit buffers */
+    uint32_t tx_alloc_failures; /*!< Transmit buffers which could not be allocated */
+    uint32_t tx_oversize_drops; /*!< Messages not sent because they exceed the maximum message size */
+    uint32_t tx_send_failures;  /*!< Messages which could not be sent */
+    uint32_t tx_pending_queued; /*!< Feature updates kept to be retried because no transmit buffer was available */
+    uint32_t tx_pending_coalesced; /*!< Feature updates which replaced a waiting update of the same feature */
+    uint32_t tx_pending_dropped; /*!< Feature updates dropped because they could not be kept for retrying */
+    uint32_t tx_fragmented;     /*!< Feature updates and events sent in fragments */
+    uint32_t rx_reassembled;    /*!< Feature updates and events reassembled from fragments */
+    uint32_t rx_fragment_drops; /*!< Fragmented records dropped as incomplete or too large */
+    uint8_t rx_event_queue_hwm; /*!< Maximum number of events waiting to be handled */
+    uint8_t rx_feature_queue_hwm; /*!< Maximum number of feature updates waiting to be handled */
+    uint8_t rx_priority_queue_hwm; /*!< Maximum number of priority events waiting to be handled */
+    low_code_transport_endpoint_stats_t endpoints[LOW_CODE_TRANSPORT_ENDPOINT_MAX]; /*!< Per endpoint statistics */
+    uint32_t rx_latency_hist[LOW_CODE_TRANSPORT_LATENCY_BUCKETS]; /*!< Cycles from taking a message out of the
+                                                                       rpmsg queue to calling its callback */
+} low_code_transport_stats_t;
+
+/**
+ * @brief Callback function type for the periodic statistics
+ */
+typedef void (*low_code_transport_stats_cb_t)(const low_code_transport_stats_t *stats);
+
 /**
  * @brief Register transport layer callbacks
  *
@@ -40,6 +102,79 @@ extern "C" {
  */
 int low_code_transport_register_callbacks(void);
 
+/**
+ * @brief Retry the feature updates which are waiting for a transmit buffer
+ *
+ * When no transmit buffer is available, a feature update is kept in a small queue instead of being
+ * dropped (CONFIG_LOW_CODE_TRANSPORT_PENDING_QUEUE_LEN), and low_code_feature_update_to_system() still
+ * succeeds. The queue is retried in order with this function, and before each new feature update.
+ *
+ * It is called in system_loop() by default.
+ */
+void low_code_transport_flush_pending(void);
+
+/**
+ * @brief Get the transport statistics
+ *
+ * @param stats Pointer to the structure to be filled
+ * @return int 0 on success, negative value on error
+ */
+int low_code_transport_get_stats(low_code_transport_stats_t *stats);
+
+/**
+ * @brief Reset the transport statistics
+ */
+void low_code_transport_reset_stats(void);
+
+/**
+ * @brief Print the transport statistics
+ *
+ * With CONFIG_LOW_CODE_TRANSPORT_STATS_DUMP_INTERVAL_MS, this is also called periodically while polling for
+ * events from the system, unless a callback is set with low_code_transport_set_stats_callback().
+ */
+void low_code_transport_dump_stats(void);
+
+/**
+ * @brief Set the callback for the periodic statistics
+ *
+ * With CONFIG_LOW_CODE_TRANSPORT_STATS_DUMP_INTERVAL_MS, the callback is called with the statistics at that
+ * interval instead of printing them, e.g. to report them to the system as a feature or to keep the worst values.
+ *
+ * @param cb Callback, NULL to print the statistics again
+ */
+void low_code_transport_set_stats_callback(low_code_transport_stats_cb_t cb);
+
+/**
+ * @brief Check if messages from the system may be waiting to be handled
+ *
+ * This is false once a poll has found the receive queue empty, and becomes true again when the
+ * system signals a new message. It is used to decide if the LP core can wait for an interrupt.
+ *
+ * @return true if the receive queue should be polled again
+ */
+bool low_code_transport_rx_pending(void);
+
+/**
+ * @brief Check if the system signals its messages with the doorbell interrupt
+ *
+ * Without the doorbell, new messages are only found by polling, so the LP core must not wait for an
+ * interrupt for long. Installing the handler does not mean that the system firmware rings the doorbell, so
+ * it only counts once it has been received.
+ *
+ * @return true once a doorbell interrupt has been received
+ */
+bool low_code_transport_rx_doorbell_confirmed(void);
+
+/**
+ * @brief Check if feature updates are waiting for a transmit buffer
+ *
+ * Transmit buffers are freed by the system without an interrupt, so these are only sent by a later
+ * low_code_transport_flush_pending().
+ *
+ * @return true if the pending queue is not empty
+ */
+bool low_code_transport_tx_pending(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,165 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+
+#include <low_code_transport_wire.h>
+
+#define WIRE_ALIGN(x) (((x) + LOW_CODE_WIRE_ALIGN - 1) & ~(LOW_CODE_WIRE_ALIGN - 1))
+#define WIRE_TAG(kind) ((LOW_CODE_WIRE_VERSION << 4) | (kind))
+
+/* Fixed part of the headers, before the varints */
+#define FEATURE_FIXED_LEN 5
+#define EVENT_FIXED_LEN 2
+
+static size_t varint_len(uint32_t value)
+{
+    size_t len = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        len++;
+    }
+    return len;
+}
+
+static size_t varint_write(uint32_t value, uint8_t *buf)
+{
+    size_t len = 0;
+    while (value >= 0x80) {
+        buf[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buf[len++] = (uint8_t)value;
+    return len;
+}
+
+/* Returns the number of bytes read, 0 if the varint does not end within len bytes or overflows */
+static size_t varint_read(const uint8_t *buf, size_t len, uint32_t *value)
+{
+    uint32_t result = 0;
+    for (size_t i = 0; i < len && i < 5; i++) {
+        result |= (uint32_t)(buf[i] & 0x7F) << (7 * i);
+        if (!(buf[i] & 0x80)) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+size_t low_code_wire_feature_header_len(const low_code_feature_data_t *data)
+{
+    return WIRE_ALIGN(FEATURE_FIXED_LEN + varint_len(data->details.feature_id) + varint_len(data->value.value_len));
+}
+
+size_t low_code_wire_encode_feature_header(const low_code_feature_data_t *data, uint8_t *buf, size_t payload_offset)
+{
+    if (data->value.value_len < 0 || payload_offset < low_code_wire_feature_header_len(data) ||
+            payload_offset > UINT8_MAX || payload_offset % LOW_CODE_WIRE_ALIGN) {
+        return 0;
+    }
+
+    buf[0] = WIRE_TAG(LOW_CODE_WIRE_KIND_FEATURE);
+    buf[1] = (uint8_t)payload_offset;
+    buf[2] = (uint8_t)data->details.endpoint_id;
+    buf[3] = (uint8_t)(data->details.endpoint_id >> 8);
+    buf[4] = (uint8_t)data->value.type;
+    size_t offset = FEATURE_FIXED_LEN;
+    offset += varint_write(data->details.feature_id, buf + offset);
+    offset += varint_write(data->value.value_len, buf + offset);
+    memset(buf + offset, 0, payload_offset - offset);
+    return payload_offset + data->value.value_len;
+}
+
+size_t low_code_wire_decode_feature(uint8_t *buf, size_t len, low_code_feature_data_t *data)
+{
+    if (len < FEATURE_FIXED_LEN || buf[0] != WIRE_TAG(LOW_CODE_WIRE_KIND_FEATURE)) {
+        return 0;
+    }
+
+    size_t payload_offset = buf[1];
+    uint32_t feature_id, value_len;
+    size_t offset = FEATURE_FIXED_LEN;
+    size_t read = varint_read(buf + offset, len - offset, &feature_id);
+    if (read == 0) {
+        return 0;
+    }
+    offset += read;
+    read = varint_read(buf + offset, len - offset, &value_len);
+    if (read == 0) {
+        return 0;
+    }
+    offset += read;
+    if (payload_offset < offset || value_len > len || payload_offset + value_len > len) {
+        return 0;
+    }
+
+    memset(data, 0, sizeof(low_code_feature_data_t));
+    data->details.endpoint_id = (uint16_t)(buf[2] | (buf[3] << 8));
+    data->details.feature_id = (low_code_feature_id_t)feature_id;
+    data->value.type = (low_code_feature_value_type_t)buf[4];
+    data->value.value_len = (int)value_len;
+    data->value.value = buf + payload_offset;
+    return payload_offset + value_len;
+}
+
+size_t low_code_wire_event_header_len(const low_code_event_t *event)
+{
+    return WIRE_ALIGN(EVENT_FIXED_LEN + varint_len(event->event_type) + varint_len(event->event_data_size));
+}
+
+size_t low_code_wire_encode_event_header(const low_code_event_t *event, uint8_t *buf, size_t payload_offset)
+{
+    if (event->event_data_size < 0 || payload_offset < low_code_wire_event_header_len(event) ||
+            payload_offset > UINT8_MAX || payload_offset % LOW_CODE_WIRE_ALIGN) {
+        return 0;
+    }
+
+    buf[0] = WIRE_TAG(LOW_CODE_WIRE_KIND_EVENT);
+    buf[1] = (uint8_t)payload_offset;
+    size_t offset = EVENT_FIXED_LEN;
+    offset += varint_write(event->event_type, buf + offset);
+    offset += varint_write(event->event_data_size, buf + offset);
+    memset(buf + offset, 0, payload_offset - offset);
+    return payload_offset + event->event_data_size;
+}
+
+size_t low_code_wire_decode_event(uint8_t *buf, size_t len, low_code_event_t *event)
+{
+    if (len < EVENT_FIXED_LEN || buf[0] != WIRE_TAG(LOW_CODE_WIRE_KIND_EVENT)) {
+        return 0;
+    }
+
+    size_t payload_offset = buf[1];
+    uint32_t event_type, data_size;
+    size_t offset = EVENT_FIXED_LEN;
+    size_t read = varint_read(buf + offset, len - offset, &event_type);
+    if (read == 0) {
+        return 0;
+    }
+    offset += read;
+    read = varint_read(buf + offset, len - offset, &data_size);
+    if (read == 0) {
+        return 0;
+    }
+    offset += read;
+    if (payload_offset < offset || data_size > len || payload_offset + data_size > len) {
+        return 0;
+    }
+
+    event->event_type = (low_code_event_type_t)event_type;
+    event->event_data_size = (int)data_size;
+    event->event_data = buf + payload_offset;
+    return payload_offset + data_size;
+}
@@ -0,0 +1,121 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file low_code_transport_wire.h
+ * @brief Compact wire encoding of feature updates and events
+ *
+ * Used by the transport when CONFIG_LOW_CODE_TRANSPORT_WIRE_FORMAT_COMPACT is selected, instead of
+ * sending the raw low_code_feature_data_t and low_code_event_t structures.
+ *
+ * Feature record:
+ *
+ *     offset  size     field
+ *     0       1        version (high nibble) | kind (low nibble, LOW_CODE_WIRE_KIND_FEATURE)
+ *     1       1        payload offset
+ *     2       2        endpoint_id, little endian
+ *     4       1        value type
+ *     5       varint   feature_id
+ *     ..      varint   value_len
+ *     ..      ..       zero padding up to the payload offset
+ *     payload offset   value
+ *
+ * Event record:
+ *
+ *     offset  size     field
+ *     0       1        version (high nibble) | kind (low nibble, LOW_CODE_WIRE_KIND_EVENT)
+ *     1       1        payload offset
+ *     2       varint   event_type
+ *     ..      varint   event_data_size
+ *     ..      ..       zero padding up to the payload offset
+ *     payload offset   event data
+ *
+ * Varints are unsigned LEB128. The payload offset is a multiple of LOW_CODE_WIRE_ALIGN, so that a
+ * value in an aligned message can be handed to the application in place. The solution specific
+ * details (low_level) and priv_data are not sent.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <low_code.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOW_CODE_WIRE_VERSION 1                 /*!< Version of the encoding */
+#define LOW_CODE_WIRE_KIND_FEATURE 1            /*!< Record is a feature update */
+#define LOW_CODE_WIRE_KIND_EVENT 2              /*!< Record is an event */
+#define LOW_CODE_WIRE_ALIGN 4                   /*!< Alignment of the payload within a record */
+#define LOW_CODE_WIRE_FEATURE_HEADER_MAX_LEN 16 /*!< Largest payload offset of a feature record */
+#define LOW_CODE_WIRE_EVENT_HEADER_MAX_LEN 12   /*!< Largest payload offset of an event record */
+
+/**
+ * @brief Length of the feature record header, i.e. the smallest payload offset for this feature
+ */
+size_t low_code_wire_feature_header_len(const low_code_feature_data_t *data);
+
+/**
+ * @brief Write the header of a feature record
+ *
+ * The value itself is not written, it is expected at buf + payload_offset.
+ * @param data Feature data
+ * @param buf Start of the record
+ * @param payload_offset Payload offset, at least low_code_wire_feature_header_len() and aligned to LOW_CODE_WIRE_ALIGN
+ * @return Length of the record (payload_offset + value_len), 0 on error
+ */
+size_t low_code_wire_encode_feature_header(const low_code_feature_data_t *data, uint8_t *buf, size_t payload_offset);
+
+/**
+ * @brief Decode a feature record
+ *
+ * @param buf Start of the record
+ * @param len Number of bytes available at buf
+ * @param[out] data Decoded feature data, value.value points into buf
+ * @return Length of the record, 0 if it is malformed or of an unknown version
+ */
+size_t low_code_wire_decode_feature(uint8_t *buf, size_t len, low_code_feature_data_t *data);
+
+/**
+ * @brief Length of the event record header, i.e. the smallest payload offset for this event
+ */
+size_t low_code_wire_event_header_len(const low_code_event_t *event);
+
+/**
+ * @brief Write the header of an event record
+ *
+ * The event data itself is not written, it is expected at buf + payload_offset.
+ * @param event Event
+ * @param buf Start of the record
+ * @param payload_offset Payload offset, at least low_code_wire_event_header_len() and aligned to LOW_CODE_WIRE_ALIGN
+ * @return Length of the record (payload_offset + event_data_size), 0 on error
+ */
+size_t low_code_wire_encode_event_header(const low_code_event_t *event, uint8_t *buf, size_t payload_offset);
+
+/**
+ * @brief Decode an event record
+ *
+ * @param buf Start of the record
+ * @param len Number of bytes available at buf
+ * @param[out] event Decoded event, event_data points into buf
+ * @return Length of the record, 0 if it is malformed or of an unknown version
+ */
+size_t low_code_wire_decode_event(uint8_t *buf, size_t len, low_code_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,177 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "profiler.h"
+
+static const char *TAG = "profiler";
+
+#if CONFIG_PROFILER_ENABLE
+
+#ifdef CONFIG_PROFILER_MAX_CALLBACKS
+#define PROFILER_MAX_CALLBACKS CONFIG_PROFILER_MAX_CALLBACKS
+#else
+#define PROFILER_MAX_CALLBACKS 16
+#endif /* CONFIG_PROFILER_MAX_CALLBACKS */
+
+#ifdef CONFIG_PROFILER_DUMP_INTERVAL_MS
+#define PROFILER_DUMP_INTERVAL_MS CONFIG_PROFILER_DUMP_INTERVAL_MS
+#else
+#define PROFILER_DUMP_INTERVAL_MS 0
+#endif /* CONFIG_PROFILER_DUMP_INTERVAL_MS */
+
+static profiler_stats_t profiler_stats;
+static profiler_callback_stats_t callbacks[PROFILER_MAX_CALLBACKS];
+static uint32_t loop_last_tick;
+static bool loop_started = false;
+#if PROFILER_DUMP_INTERVAL_MS
+static uint32_t dump_last_tick;
+#endif
+
+static void span_record(profiler_span_t *span, uint32_t cycles)
+{
+    if (span->count == 0 || cycles < span->min_cycles) {
+        span->min_cycles = cycles;
+    }
+    if (cycles > span->max_cycles) {
+        span->max_cycles = cycles;
+    }
+    span->total_cycles += cycles;
+    span->count++;
+}
+
+void profiler_loop_end(uint32_t idle_cycles)
+{
+    uint32_t tick = RV_READ_CSR(mcycle);
+    if (loop_started) {
+        span_record(&profiler_stats.loop, tick - loop_last_tick - idle_cycles);
+    }
+    loop_last_tick = tick;
+    loop_started = true;
+
+#if PROFILER_DUMP_INTERVAL_MS
+    if (tick - dump_last_tick >= (uint32_t)PROFILER_DUMP_INTERVAL_MS * PROFILER_CYCLES_PER_US * 1000) {
+        dump_last_tick = tick;
+        profiler_dump();
+    }
+#endif
+}
+
+void profiler_timer_lateness(uint32_t cycles)
+{
+    span_record(&profiler_stats.timer_lateness, cycles);
+}
+
+void profiler_callback_end(profiler_callback_type_t type, const void *fn, uint32_t start)
+{
+    uint32_t cycles = RV_READ_CSR(mcycle) - start;
+
+    /* The table only holds the few callbacks of the application, a linear search is enough */
+    uint32_t i;
+    for (i = 0; i < profiler_stats.callback_count; i++) {
+        if (callbacks[i].fn == fn && callbacks[i].type == type) {
+            break;
+        }
+    }
+    if (i == profiler_stats.callback_count) {
+        if (i == PROFILER_MAX_CALLBACKS) {
+            profiler_stats.callback_overflow++;
+            return;
+        }
+        memset(&callbacks[i], 0, sizeof(callbacks[i]));
+        callbacks[i].fn = fn;
+        callbacks[i].type = type;
+        profiler_stats.callback_count++;
+    }
+    span_record(&callbacks[i].cycles, cycles);
+}
+
+int profiler_get_stats(profiler_stats_t *stats)
+{
+    if (!stats) {
+        return -1;
+    }
+    *stats = profiler_stats;
+    return 0;
+}
+
+int profiler_get_callback_stats(int index, profiler_callback_stats_t *stats)
+{
+    if (!stats || index < 0 || (uint32_t)index >= profiler_stats.callback_count) {
+        return -1;
+    }
+    *stats = callbacks[index];
+    return 0;
+}
+
+void profiler_reset(void)
+{
+    memset(&profiler_stats, 0, sizeof(profiler_stats));
+    loop_started = false;
+}
+
+static uint32_t span_mean(const profiler_span_t *span)
+{
+    return span->count ? (uint32_t)(span->total_cycles / span->count) : 0;
+}
+
+static void span_print(const char *name, const profiler_span_t *span)
+{
+    printf("%s: %-10s %8lu %8lu %8lu %8lu\n", TAG, name, span->count,
+           span->min_cycles / PROFILER_CYCLES_PER_US, span_mean(span) / PROFILER_CYCLES_PER_US,
+           span->max_cycles / PROFILER_CYCLES_PER_US);
+}
+
+void profiler_dump(void)
+{
+    static const char *type_names[] = {"timer", "transport", "job"};
+
+    printf("%s: %-10s %8s %8s %8s %8s %s\n", TAG, "(us)", "count", "min", "mean", "max", "function");
+    span_print("loop", &profiler_stats.loop);
+    span_print("lateness", &profiler_stats.timer_lateness);
+    for (uint32_t i = 0; i < profiler_stats.callback_count; i++) {
+        printf("%s: %-10s %8lu %8lu %8lu %8lu %p\n", TAG, type_names[callbacks[i].type], callbacks[i].cycles.count,
+               callbacks[i].cycles.min_cycles / PROFILER_CYCLES_PER_US,
+               span_mean(&callbacks[i].cycles) / PROFILER_CYCLES_PER_US,
+               callbacks[i].cycles.max_cycles / PROFILER_CYCLES_PER_US, callbacks[i].fn);
+    }
+    if (profiler_stats.callback_overflow) {
+        printf("%s: %lu calls of further callbacks not profiled\n", TAG, profiler_stats.callback_overflow);
+    }
+}
+
+#else
+
+int profiler_get_stats(profiler_stats_t *stats)
+{
+    return -1;
+}
+
+int profiler_get_callback_stats(int index, profiler_callback_stats_t *stats)
+{
+    return -1;
+}
+
+void profiler_reset(void)
+{
+}
+
+void profiler_dump(void)
+{
+    printf("%s: Profiler is disabled, enable CONFIG_PROFILER_ENABLE\n", TAG);
+}
+
+#endif /* CONFIG_PROFILER_ENABLE */
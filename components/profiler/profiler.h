@@ -0,0 +1,189 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file profiler.h
+ * @brief Main loop profiler for LP core
+ *
+ * This component measures the main loop iterations, the lateness of the software timers and the
+ * cycles spent in every timer handler, transport callback and posted job, keyed by the address of
+ * the function. It is enabled with CONFIG_PROFILER_ENABLE, otherwise the recording functions are
+ * empty and the measurement points cost nothing.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <sdkconfig.h>
+#include <riscv/rv_utils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief LP core cycles per microsecond, to convert the measurements */
+#define PROFILER_CYCLES_PER_US 16
+
+/**
+ * @brief Kind of the profiled callback
+ */
+typedef enum {
+    PROFILER_CALLBACK_TIMER = 0,    /**< Software timer handler */
+    PROFILER_CALLBACK_TRANSPORT,    /**< Feature update or event callback called for a message from the system */
+    PROFILER_CALLBACK_JOB,          /**< Job posted with system_post() */
+} profiler_callback_type_t;
+
+/**
+ * @brief Distribution of a measured duration, in LP core cycles
+ */
+typedef struct {
+    uint32_t count;         /**< Number of measurements */
+    uint32_t min_cycles;    /**< Shortest measurement */
+    uint32_t max_cycles;    /**< Longest measurement */
+    uint64_t total_cycles;  /**< Sum of the measurements, the mean is total_cycles / count */
+} profiler_span_t;
+
+/**
+ * @brief Cycles spent in one callback function
+ */
+typedef struct {
+    const void *fn;                 /**< Address of the callback function */
+    profiler_callback_type_t type;  /**< Kind of the callback */
+    profiler_span_t cycles;         /**< Cycles per call, including the callbacks it calls itself */
+} profiler_callback_stats_t;
+
+/**
+ * @brief Main loop profile
+ */
+typedef struct {
+    profiler_span_t loop;           /**< Time between two calls of system_loop(), without the wait for interrupt */
+    profiler_span_t timer_lateness; /**< Time between the deadline of a software timer and the call of its handler */
+    uint32_t callback_count;        /**< Number of callback functions in the table */
+    uint32_t callback_overflow;     /**< Number of calls not profiled because the table was full */
+} profiler_stats_t;
+
+#if CONFIG_PROFILER_ENABLE
+
+/**
+ * @brief Start a measurement
+ *
+ * @return Cycle counter to pass to the matching end function
+ */
+static inline uint32_t profiler_begin(void)
+{
+    return RV_READ_CSR(mcycle);
+}
+
+/**
+ * @brief End a main loop iteration
+ *
+ * The iteration lasts from the previous call, so it includes the work of the application main loop
+ * between two calls of system_loop().
+ *
+ * @note This function is called by system_loop()
+ *
+ * @param idle_cycles Cycles spent waiting for an interrupt during the iteration, which are not counted
+ */
+void profiler_loop_end(uint32_t idle_cycles);
+
+/**
+ * @brief Record the lateness of a software timer
+ *
+ * @note This function is called by sw_timer_run()
+ *
+ * @param cycles Cycles between the deadline and the call of the handler
+ */
+void profiler_timer_lateness(uint32_t cycles);
+
+/**
+ * @brief End the measurement of a callback
+ *
+ * @param type Kind of the callback
+ * @param fn Address of the callback function
+ * @param start Value returned by profiler_begin() before calling the callback
+ */
+void profiler_callback_end(profiler_callback_type_t type, const void *fn, uint32_t start);
+
+#else
+
+static inline uint32_t profiler_begin(void)
+{
+    return 0;
+}
+
+static inline void profiler_loop_end(uint32_t idle_cycles)
+{
+}
+
+static inline void profiler_timer_lateness(uint32_t cycles)
+{
+}
+
+static inline void profiler_callback_end(profiler_callback_type_t type, const void *fn, uint32_t start)
+{
+}
+
+#endif /* CONFIG_PROFILER_ENABLE */
+
+/**
+ * @brief Measure a callback call
+ *
+ * @param type Kind of the callback, profiler_callback_type_t
+ * @param fn Callback function
+ * @param call Statement calling the callback
+ */
+#define PROFILER_CALLBACK(type, fn, call) do {                          \
+        uint32_t profiler_start = profiler_begin();                     \
+        call;                                                           \
+        profiler_callback_end((type), (const void *)(fn), profiler_start); \
+    } while (0)
+
+/**
+ * @brief Get the main loop profile
+ *
+ * @param stats Pointer to the structure to be filled
+ *
+ * @return
+ *      - 0 on success
+ *      - -1 on failure or if the profiler is disabled
+ */
+int profiler_get_stats(profiler_stats_t *stats);
+
+/**
+ * @brief Get the cycles spent in a callback function
+ *
+ * @param index Index of the callback, from 0 to profiler_stats_t::callback_count - 1
+ * @param stats Pointer to the structure to be filled
+ *
+ * @return
+ *      - 0 on success
+ *      - -1 on failure or if the profiler is disabled
+ */
+int profiler_get_callback_stats(int index, profiler_callback_stats_t *stats);
+
+/**
+ * @brief Reset the main loop profile and the callback table
+ */
+void profiler_reset(void);
+
+/**
+ * @brief Print the main loop profile and the callback table, in microseconds
+ */
+void profiler_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,9 +3,12 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <limits.h>
+#include <string.h>
 
 #include <riscv/rv_utils.h>
 #include <ulp_lp_core_print.h>
+#include <profiler.h>
+#include <system.h>
 
 #include "sw_timer.h"
 
@@ -15,24 +18,149 @@
 #define  SW_TIMER_MAX_ITEMS 10
 #endif /* CONFIG_MAX_SOFTWARE_TIMERS */
 
-#define LP_CORE_FREQ_IN_KHZ 16000
-
 static const char *TAG = "sw_timer";
 
 typedef struct {
     bool active; /* false means a suspended/uninitialized timer */
     bool valid; /* whether this timer is valid or not */
     bool periodic; /* auto-reload the timer if it is periodic */
-    uint32_t last_tick; /* last tick */
-    int64_t remain_ticks; /* remain ticks to call the timer callback */
+    uint16_t heap_index; /* position in the deadline heap while active */
+    uint64_t deadline; /* system_clock_cycles() at which the timer expires */
     int timeout_ms; /* timeout period */
+    int slack_ms; /* time after the deadline within which the timer may run */
     sw_timer_cb_t handler; /* callback */
     void *arg;
+    sw_timer_stats_t stats; /* lateness and missed periods */
 } sw_timer_t;
 
 /* zerocode timer */
 static sw_timer_t g_timers[SW_TIMER_MAX_ITEMS];
 
+/* Active timers as a binary min-heap on the deadline: the earliest timer is always g_heap[0], so checking for
+ * expired timers is a single compare, and starting or stopping a timer moves it by at most log2(n) levels. */
+static sw_timer_t *g_heap[SW_TIMER_MAX_ITEMS];
+static uint16_t g_heap_count = 0;
+
+/**
+ * @brief disable interrupts, returns whether they were enabled
+ *
+ * Timers are started from interrupt handlers (e.g. the button debounce timer), which must not run while the heap
+ * is being reordered. The previous state is restored, so this can also be used inside an interrupt handler.
+*/
+static inline uint32_t sw_timer_lock(void)
+{
+    return RV_CLEAR_CSR(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+}
+
+static inline void sw_timer_unlock(uint32_t state)
+{
+    if (state) {
+        RV_SET_CSR(mstatus, MSTATUS_MIE);
+    }
+}
+
+static inline void heap_set(uint16_t index, sw_timer_t *timer)
+{
+    g_heap[index] = timer;
+    timer->heap_index = index;
+}
+
+static void heap_sift_up(uint16_t index)
+{
+    sw_timer_t *timer = g_heap[index];
+    while (index > 0) {
+        uint16_t parent = (index - 1) / 2;
+        if (g_heap[parent]->deadline <= timer->deadline) {
+            break;
+        }
+        heap_set(index, g_heap[parent]);
+        index = parent;
+    }
+    heap_set(index, timer);
+}
+
+static void heap_sift_down(uint16_t index)
+{
+    sw_timer_t *timer = g_heap[index];
+    while (true) {
+        uint16_t child = 2 * index + 1;
+        if (child >= g_heap_count) {
+            break;
+        }
+        if (child + 1 < g_heap_count && g_heap[child + 1]->deadline < g_heap[child]->deadline) {
+            child++;
+        }
+        if (timer->deadline <= g_heap[child]->deadline) {
+            break;
+        }
+        heap_set(index, g_heap[child]);
+        index = child;
+    }
+    heap_set(index, timer);
+}
+
+static void heap_insert(sw_timer_t *timer)
+{
+    heap_set(g_heap_count, timer);
+    g_heap_count++;
+    heap_sift_up(timer->heap_index);
+}
+
+static void heap_remove(sw_timer_t *timer)
+{
+    uint16_t index = timer->heap_index;
+    g_heap_count--;
+    if (index == g_heap_count) {
+        return;
+    }
+    /* Move the last timer into the hole, it may need to go either way */
+    sw_timer_t *moved = g_heap[g_heap_count];
+    heap_set(index, moved);
+    heap_sift_up(index);
+    if (moved->heap_index == index) {
+        heap_sift_down(index);
+    }
+}
+
+/* Latest time at which the timer can run */
+static inline uint64_t sw_timer_latest(sw_timer_t *timer)
+{
+    return timer->deadline + (uint64_t)timer->slack_ms * SYSTEM_CLOCK_CYCLES_PER_MS;
+}
+
+/* Earliest end of a timer window in the subtree at index, or best if that is earlier. A subtree whose
+ * earliest deadline is not before best cannot end earlier and is skipped: without slack only the root is read. */
+static uint64_t heap_min_latest(uint16_t index, uint64_t best)
+{
+    if (index >= g_heap_count || g_heap[index]->deadline >= best) {
+        return best;
+    }
+    uint64_t latest = sw_timer_latest(g_heap[index]);
+    if (latest < best) {
+        best = latest;
+    }
+    best = heap_min_latest(2 * index + 1, best);
+    return heap_min_latest(2 * index + 2, best);
+}
+
+static bool sw_timer_slack_valid(bool periodic, int timeout_ms, int slack_ms)
+{
+    return slack_ms >= 0 && (!periodic || slack_ms < timeout_ms);
+}
+
+/* (Re)schedule an active or inactive timer at deadline */
+static void sw_timer_schedule(sw_timer_t *timer, uint64_t deadline)
+{
+    timer->deadline = deadline;
+    if (!timer->active) {
+        timer->active = true;
+        heap_insert(timer);
+        return;
+    }
+    heap_sift_up(timer->heap_index);
+    heap_sift_down(timer->heap_index);
+}
+
 /**
  * @brief create zerocode timer
  *
@@ -50,6 +178,11 @@ sw_timer_handle_t sw_timer_create(sw_timer_config_t *config)
         return NULL;
     }
 
+    if (!sw_timer_slack_valid(config->periodic, config->timeout_ms, config->slack_ms)) {
+        printf("%s: %s Invalid slack_ms=%d\n", TAG, __func__, config->slack_ms);
+        return NULL;
+    }
+
     sw_timer_t *timer = NULL;
 
     for (int i=0; i<SW_TIMER_MAX_ITEMS; i++) {
@@ -66,6 +199,8 @@ sw_timer_handle_t sw_timer_create(sw_timer_config_t *config)
         timer->valid = true;
         timer->timeout_ms = config->timeout_ms;
         timer->periodic = config->periodic;
+        timer->slack_ms = config->slack_ms;
+        memset(&timer->stats, 0, sizeof(timer->stats));
     }
     else {
         printf("%s: Lack of memory for sw_timer\n", TAG);
@@ -84,17 +219,22 @@ int sw_timer_delete(sw_timer_handle_t timer_handle)
     }
 
     sw_timer_t *timer = (sw_timer_t *)timer_handle;
+    uint32_t state = sw_timer_lock();
+    if (timer->valid && timer->active) {
+        heap_remove(timer);
+    }
     timer->active = false;
     timer->handler = NULL;
     timer->arg = NULL;
-    timer->remain_ticks = -1;
     timer->valid = false;
+    sw_timer_unlock(state);
     return 0;
 }
 
 /**
  * @brief start timer
  *
+ * Restarting an active timer moves its deadline.
 */
 int sw_timer_start(sw_timer_handle_t timer_handle)
 {
@@ -104,18 +244,15 @@ int sw_timer_start(sw_timer_handle_t timer_handle)
         return -1;
     }
 
-    /* calculate remain_ticks */
-    timer->remain_ticks = (int64_t)(timer->timeout_ms) * LP_CORE_FREQ_IN_KHZ;
-
-    if (timer->remain_ticks == 0) {
-        /* if remain_ticks=0, call handler immediately and stop timer */
-        timer->handler(timer_handle, timer->arg);
+    if (timer->timeout_ms == 0) {
+        /* if timeout is 0, call handler immediately and stop timer */
+        PROFILER_CALLBACK(PROFILER_CALLBACK_TIMER, timer->handler, timer->handler(timer_handle, timer->arg));
         sw_timer_stop(timer);
     }
     else {
-        /* update timer's last tick */
-        timer->last_tick = RV_READ_CSR(mcycle);
-        timer->active = 1;
+        uint32_t state = sw_timer_lock();
+        sw_timer_schedule(timer, system_clock_cycles() + (uint64_t)timer->timeout_ms * SYSTEM_CLOCK_CYCLES_PER_MS);
+        sw_timer_unlock(state);
     }
 
     return 0;
@@ -123,8 +260,6 @@ int sw_timer_start(sw_timer_handle_t timer_handle)
 
 /**
  * @brief stop a timer
- *
- * update the last_tick & remain_ticks immediately
 */
 int sw_timer_stop(sw_timer_handle_t timer_handle)
 {
@@ -135,37 +270,148 @@ int sw_timer_stop(sw_timer_handle_t timer_handle)
         return -1;
     }
 
-    if(timer->active == false) return 0;
-    timer->active = false;
+    uint32_t state = sw_timer_lock();
+    if (timer->active) {
+        heap_remove(timer);
+        timer->active = false;
+    }
+    sw_timer_unlock(state);
     return 0;
 }
 
 
+/**
+ * @brief record the lateness of a timer which is about to run
+*/
+static void sw_timer_record_lateness(sw_timer_t *timer, uint64_t lateness)
+{
+    uint64_t lateness_us = lateness / SYSTEM_CLOCK_CYCLES_PER_US;
+    uint64_t bound_us = 100;
+    int bucket = 0;
+    while (bucket < SW_TIMER_LATENESS_BUCKETS - 1 && lateness_us >= bound_us) {
+        bucket++;
+        bound_us *= 10;
+    }
+    timer->stats.lateness_hist[bucket]++;
+    timer->stats.fire_count++;
+    if (lateness_us > timer->stats.max_lateness_us) {
+        timer->stats.max_lateness_us = lateness_us >= UINT32_MAX ? UINT32_MAX : (uint32_t)lateness_us;
+    }
+    profiler_timer_lateness(lateness >= UINT32_MAX ? UINT32_MAX : (uint32_t)lateness);
+}
+
 /**
  * @brief call from main function to update the timer list
+ *
+ * Only the earliest timer is checked, the others expire later.
 */
 void sw_timer_run(void)
 {
-    for (int i=0; i<SW_TIMER_MAX_ITEMS; i++) {
-        if (g_timers[i].valid && g_timers[i].active) {
-            /* calculate escaped ticks & update last tick */
-            uint32_t tick = RV_READ_CSR(mcycle); /* bugfix: time_gap overflow when timer started inside another timer cb */
-            uint32_t time_gap = tick - g_timers[i].last_tick;
-            g_timers[i].last_tick = tick; /* update last_tick */
-            g_timers[i].remain_ticks -= (int64_t)time_gap; /* update remain_ticks */
-
-            if (g_timers[i].remain_ticks <= 0) {
-                /* handler may delete/stop timer. update timer status before executing handler */
-                if (g_timers[i].periodic) {
-                    /* periodic, reload timer. if not, stop timer */
-                    sw_timer_start(&(g_timers[i]));
-                } else {
-                    sw_timer_stop(&(g_timers[i]));
-                }
-
-                /* call handler */
-                g_timers[i].handler(&(g_timers[i]), g_timers[i].arg);
+    uint32_t state = sw_timer_lock();
+    uint64_t now = system_clock_cycles();
+
+    /* Timers run as soon as their deadline has passed, also within their slack, so that they share this wakeup.
+     * A periodic timer is rescheduled after now, so every timer runs at most once per call */
+    while (g_heap_count > 0 && g_heap[0]->deadline <= now) {
+        sw_timer_t *timer = g_heap[0];
+        sw_timer_record_lateness(timer, now - timer->deadline);
+
+        /* handler may delete/stop timer. update timer status before executing handler */
+        if (timer->periodic) {
+            /* periodic, reload timer from its previous deadline to keep the phase. if not, stop timer */
+            uint64_t period = (uint64_t)timer->timeout_ms * SYSTEM_CLOCK_CYCLES_PER_MS;
+            uint64_t deadline = timer->deadline + period;
+            if (deadline <= now) {
+                /* Whole periods have passed, skip them instead of running the handler back to back */
+                uint64_t missed = (now - timer->deadline) / period;
+                timer->stats.missed_count += missed;
+                deadline = timer->deadline + (missed + 1) * period;
             }
+            sw_timer_schedule(timer, deadline);
+        } else {
+            heap_remove(timer);
+            timer->active = false;
         }
+        sw_timer_cb_t handler = timer->handler;
+        void *arg = timer->arg;
+
+        /* call handler, with interrupts enabled */
+        sw_timer_unlock(state);
+        PROFILER_CALLBACK(PROFILER_CALLBACK_TIMER, handler, handler(timer, arg));
+        state = sw_timer_lock();
+    }
+    sw_timer_unlock(state);
+}
+
+/**
+ * @brief get the time until the earliest active timer expires
+*/
+uint32_t sw_timer_next_deadline(void)
+{
+    uint32_t state = sw_timer_lock();
+    if (g_heap_count == 0) {
+        sw_timer_unlock(state);
+        return UINT32_MAX;
+    }
+
+    uint64_t now = system_clock_cycles();
+    uint64_t deadline = heap_min_latest(0, UINT64_MAX);
+    sw_timer_unlock(state);
+    if (deadline <= now) {
+        return 0;
     }
+
+    uint64_t next_us = (deadline - now) / SYSTEM_CLOCK_CYCLES_PER_US;
+    return next_us >= UINT32_MAX ? UINT32_MAX - 1 : (uint32_t)next_us;
+}
+
+/**
+ * @brief set the slack of a timer
+ *
+ * An active timer keeps its deadline, the new slack applies to its current window.
+*/
+int sw_timer_set_slack(sw_timer_handle_t timer_handle, int slack_ms)
+{
+    sw_timer_t *timer = (sw_timer_t *)timer_handle;
+    if (timer == NULL || timer->valid == false) {
+        printf("%s: %s Invalid timer\n", TAG, __func__);
+        return -1;
+    }
+    if (!sw_timer_slack_valid(timer->periodic, timer->timeout_ms, slack_ms)) {
+        printf("%s: %s Invalid slack_ms=%d\n", TAG, __func__, slack_ms);
+        return -1;
+    }
+
+    timer->slack_ms = slack_ms;
+    return 0;
+}
+
+/**
+ * @brief get the statistics of a timer
+*/
+int sw_timer_get_stats(sw_timer_handle_t timer_handle, sw_timer_stats_t *stats)
+{
+    sw_timer_t *timer = (sw_timer_t *)timer_handle;
+    if (timer == NULL || timer->valid == false || stats == NULL) {
+        printf("%s: %s Invalid timer\n", TAG, __func__);
+        return -1;
+    }
+
+    *stats = timer->stats;
+    return 0;
+}
+
+/**
+ * @brief reset the statistics of a timer
+*/
+int sw_timer_reset_stats(sw_timer_handle_t timer_handle)
+{
+    sw_timer_t *timer = (sw_timer_t *)timer_handle;
+    if (timer == NULL || timer->valid == false) {
+        printf("%s: %s Invalid timer\n", TAG, __func__);
+        return -1;
+    }
+
+    memset(&timer->stats, 0, sizeof(timer->stats));
+    return 0;
 }
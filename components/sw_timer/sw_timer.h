@@ -23,6 +23,7 @@
 #pragma once
 
 #include "stdbool.h"
+#include "stdint.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,8 +43,27 @@ typedef struct {
     int timeout_ms;             /** Timeout period in milliseconds */
     sw_timer_cb_t handler;   /** Callback function to be called when timer expires */
     void *arg;                  /** User data to pass to callback function */
+    int slack_ms;               /** Time after the timeout within which the callback may run late, to share a wakeup
+                                    with other timers. 0 for none, less than timeout_ms for a periodic timer */
 } sw_timer_config_t;
 
+/** @brief Number of buckets in the lateness histogram of a timer */
+#define SW_TIMER_LATENESS_BUCKETS 5
+
+/**
+ * @brief Statistics of a software timer
+ *
+ * The lateness is the time from the deadline of the timer to the sw_timer_run() call which runs it, and
+ * includes the slack the timer was run with.
+ * The histogram buckets are decades: below 100 us, below 1 ms, below 10 ms, below 100 ms, and 100 ms or more.
+ */
+typedef struct {
+    uint32_t fire_count;        /** Number of times the callback was called */
+    uint32_t missed_count;      /** Periods of a periodic timer skipped because a full period had passed */
+    uint32_t max_lateness_us;   /** Highest lateness */
+    uint32_t lateness_hist[SW_TIMER_LATENESS_BUCKETS]; /** Number of calls per lateness bucket */
+} sw_timer_stats_t;
+
 /**
  * @brief Create a new software timer
  *
@@ -81,9 +101,53 @@ int sw_timer_stop(sw_timer_handle_t timer_handle);
  *
  * This function should be called periodically to process timer events.
  * It checks for expired timers and calls their callbacks.
+ *
+ * Every timer whose timeout has passed runs, including timers still within their slack, so timers share
+ * the wakeup of the earliest one. A periodic timer keeps its phase: the next deadline is the previous
+ * deadline plus the period, so lateness and slack do not accumulate. If the timer runs a full period or more late, the passed periods are counted as missed
+ * and skipped instead of being run back to back.
  */
 void sw_timer_run(void);
 
+/**
+ * @brief Get the time until the next timer expires
+ *
+ * This can be used to decide how long the LP core can wait for an interrupt before
+ * sw_timer_run() needs to be called again. With slack, this is the end of the earliest timer window,
+ * so that the timers whose windows overlap it run in one wakeup. Only timers which expire before that
+ * time are visited, without slack it only reads the earliest timer, in constant time.
+ *
+ * @return uint32_t Microseconds until a timer must run, 0 if a timer has already reached the end of its
+ *         slack, UINT32_MAX if no timer is active
+ */
+uint32_t sw_timer_next_deadline(void);
+
+/**
+ * @brief Set the slack of a software timer
+ *
+ * @param timer_handle Handle of the timer
+ * @param slack_ms Time after the timeout within which the callback may run, see sw_timer_config_t
+ * @return int 0 on success, negative value on error
+ */
+int sw_timer_set_slack(sw_timer_handle_t timer_handle, int slack_ms);
+
+/**
+ * @brief Get the statistics of a software timer
+ *
+ * @param timer_handle Handle of the timer
+ * @param stats Pointer to the statistics to fill
+ * @return int 0 on success, negative value on error
+ */
+int sw_timer_get_stats(sw_timer_handle_t timer_handle, sw_timer_stats_t *stats);
+
+/**
+ * @brief Reset the statistics of a software timer
+ *
+ * @param timer_handle Handle of the timer
+ * @return int 0 on success, negative value on error
+ */
+int sw_timer_reset_stats(sw_timer_handle_t timer_handle);
+
 #ifdef __cplusplus
 }
 #endif
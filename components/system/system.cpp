@@ -12,7 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string.h>
+
+#include <sdkconfig.h>
+#include <riscv/rv_utils.h>
 #include <ulp_lp_core_utils.h>
+#include <ulp_lp_core_interrupts.h>
+#include <ulp_lp_core_lp_timer_shared.h>
+#include <hal/lp_timer_ll.h>
 #include <hal/gpio_ll.h>
 #include <hal/gpio_types.h>
 #include <soc/gpio_struct.h>
@@ -22,17 +29,127 @@
 #include <sw_timer.h>
 #include <esp_amp_platform.h>
 #include <low_code_transport.h>
+#include <profiler.h>
 
 #include <system.h>
 
+#ifdef CONFIG_SYSTEM_IDLE_MIN_TIME_US
+#define SYSTEM_IDLE_MIN_TIME_US CONFIG_SYSTEM_IDLE_MIN_TIME_US
+#else
+#define SYSTEM_IDLE_MIN_TIME_US 500
+#endif /* CONFIG_SYSTEM_IDLE_MIN_TIME_US */
+
+#ifdef CONFIG_SYSTEM_IDLE_MAX_TIME_MS
+#define SYSTEM_IDLE_MAX_TIME_MS CONFIG_SYSTEM_IDLE_MAX_TIME_MS
+#else
+#define SYSTEM_IDLE_MAX_TIME_MS 100
+#endif /* CONFIG_SYSTEM_IDLE_MAX_TIME_MS */
+
+/* The 64 bit clock must be read at least once per mcycle period (268 s), so even a tickless wait is bounded */
+#define SYSTEM_IDLE_CLOCK_MAX_TIME_US (120 * 1000 * 1000)
+
+#ifdef CONFIG_SYSTEM_IDLE_TICKLESS
+#define SYSTEM_IDLE_TICKLESS 1
+#else
+#define SYSTEM_IDLE_TICKLESS 0
+#endif /* CONFIG_SYSTEM_IDLE_TICKLESS */
+
+static system_idle_stats_t idle_stats;
+static uint32_t loop_last_tick;
+static volatile bool wakeup_pending = false;
+
+#if CONFIG_SYSTEM_IDLE_WAIT_FOR_INTERRUPT
+/* The LP timer alarm is only used to end the wait, clear it so that it does not fire again */
+void ulp_lp_core_lp_timer_intr_handler(void)
+{
+    lp_timer_ll_clear_lp_alarm_intr_status(&LP_TIMER);
+}
+
+/* Returns the cycles spent waiting for an interrupt */
+static uint32_t system_idle()
+{
+    /* Interrupts are disabled before checking for pending work: an interrupt which arrives after the check
+     * stays pending and ends the wait immediately, instead of being handled before the wait and lost */
+    ulp_lp_core_intr_disable();
+
+    uint32_t timeout_us = sw_timer_next_deadline();
+    if (wakeup_pending || system_jobs_pending() || low_code_transport_rx_pending() || timeout_us < SYSTEM_IDLE_MIN_TIME_US) {
+        wakeup_pending = false;
+        ulp_lp_core_intr_enable();
+        return 0;
+    }
+
+    /* Bound the wait, unless the system is known to signal its messages and no transmit buffer is awaited */
+    bool bounded = !SYSTEM_IDLE_TICKLESS || !low_code_transport_rx_doorbell_confirmed() || low_code_transport_tx_pending();
+    if (bounded && timeout_us > SYSTEM_IDLE_MAX_TIME_MS * 1000) {
+        timeout_us = SYSTEM_IDLE_MAX_TIME_MS * 1000;
+    }
+    if (timeout_us > SYSTEM_IDLE_CLOCK_MAX_TIME_US) {
+        timeout_us = SYSTEM_IDLE_CLOCK_MAX_TIME_US;
+    }
+    ulp_lp_core_lp_timer_set_wakeup_time(timeout_us);
+    lp_timer_ll_lp_alarm_intr_enable(&LP_TIMER, true);
+
+    uint32_t start_tick = RV_READ_CSR(mcycle);
+    ulp_lp_core_wait_for_intr();
+    uint32_t idle_cycles = RV_READ_CSR(mcycle) - start_tick;
+    idle_stats.idle_cycles += idle_cycles;
+    idle_stats.idle_count++;
+
+    lp_timer_ll_lp_alarm_intr_enable(&LP_TIMER, false);
+
+    /* The interrupt which ended the wait is handled here */
+    ulp_lp_core_intr_enable();
+    return idle_cycles;
+}
+#endif /* CONFIG_SYSTEM_IDLE_WAIT_FOR_INTERRUPT */
+
 void system_loop()
 {
+    uint32_t tick = RV_READ_CSR(mcycle);
+    idle_stats.total_cycles += (uint32_t)(tick - loop_last_tick);
+    loop_last_tick = tick;
+
+    system_snapshot_replay();
+    uint32_t idle_cycles = 0;
+#if CONFIG_SYSTEM_IDLE_WAIT_FOR_INTERRUPT
+    idle_cycles = system_idle();
+#endif
+    low_code_transport_flush_pending();
     system_timer_update();
+    system_run_jobs();
+    profiler_loop_end(idle_cycles);
 }
 
 void system_setup()
 {
     low_code_transport_register_callbacks();
+    system_snapshot_restore();
+    loop_last_tick = RV_READ_CSR(mcycle);
+#if CONFIG_SYSTEM_IDLE_WAIT_FOR_INTERRUPT
+    /* The message doorbell from the system and the forwarded HP GPIO interrupts are software interrupts */
+    ulp_lp_core_sw_intr_enable(true);
+#endif
+}
+
+void system_wakeup()
+{
+    wakeup_pending = true;
+}
+
+int system_get_idle_stats(system_idle_stats_t *stats)
+{
+    if (!stats) {
+        return -1;
+    }
+    *stats = idle_stats;
+    return 0;
+}
+
+void system_reset_idle_stats()
+{
+    memset(&idle_stats, 0, sizeof(idle_stats));
+    loop_last_tick = RV_READ_CSR(mcycle);
 }
 
 void system_timer_update()
@@ -62,7 +179,7 @@ void system_delay_us(uint32_t us)
 
 uint32_t system_get_time()
 {
-    return esp_amp_platform_get_time_ms();
+    return (uint32_t)system_clock_ms();
 }
 
 system_timer_handle_t system_timer_create(system_timer_cb_t callback, void *arg, int timeout_ms, bool periodic)
@@ -91,6 +208,11 @@ int system_timer_delete(system_timer_handle_t handle)
     return sw_timer_delete(handle);
 }
 
+int system_timer_set_slack(system_timer_handle_t handle, int slack_ms)
+{
+    return sw_timer_set_slack(handle, slack_ms);
+}
+
 void system_enable_software_interrupt()
 {
     ulp_lp_core_sw_intr_enable(true);
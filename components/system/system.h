@@ -29,6 +29,16 @@
 extern "C" {
 #endif
 
+/**
+ * @brief LP core cycles per microsecond, the resolution of the system clock
+ */
+#define SYSTEM_CLOCK_CYCLES_PER_US 16
+
+/**
+ * @brief LP core cycles per millisecond
+ */
+#define SYSTEM_CLOCK_CYCLES_PER_MS (SYSTEM_CLOCK_CYCLES_PER_US * 1000)
+
 /**
  * @brief System software timer handle.
  */
@@ -39,6 +49,11 @@ typedef void *system_timer_handle_t;
  */
 typedef void (* system_timer_cb_t)(system_timer_handle_t timer_handle, void *user_data);
 
+/**
+ * @brief Deferred job function posted with system_post()
+ */
+typedef void (* system_job_fn_t)(void *arg);
+
 /**
  * @brief Pin mode configuration options
  */
@@ -55,11 +70,35 @@ typedef enum {
     HIGH,     /**< Pin level high (3.3V/5V) */
 } pin_level_t;
 
+/**
+ * @brief Idle time accounting of the main loop
+ */
+typedef struct {
+    uint64_t total_cycles;  /**< LP core cycles spent in the main loop */
+    uint64_t idle_cycles;   /**< LP core cycles spent waiting for an interrupt */
+    uint32_t idle_count;    /**< Number of times the main loop waited for an interrupt */
+} system_idle_stats_t;
+
+/**
+ * @brief Deferred job accounting
+ */
+typedef struct {
+    uint32_t run_count;         /**< Number of jobs run */
+    uint32_t post_failures;     /**< Number of jobs not posted because the queue was full */
+    uint32_t budget_exhausted;  /**< Number of main loop iterations which left jobs for the next one */
+    uint32_t queue_hwm;         /**< Highest number of jobs waiting in the queue */
+} system_job_stats_t;
+
 /**
  * @brief Main system loop function
  *
  * This function should be called repeatedly in the main loop.
- * It handles system tasks and updates.
+ * It handles system tasks and updates, then runs the jobs posted with system_post().
+ *
+ * With CONFIG_SYSTEM_IDLE_WAIT_FOR_INTERRUPT, it waits for an interrupt when no message from the
+ * system is pending and no timer is about to expire. The wait ends on the next message, a GPIO
+ * interrupt, system_wakeup() or the next timer deadline. The wait is bounded by CONFIG_SYSTEM_IDLE_MAX_TIME_MS,
+ * unless CONFIG_SYSTEM_IDLE_TICKLESS is set and the system signals its messages with an interrupt.
  */
 void system_loop();
 
@@ -68,9 +107,34 @@ void system_loop();
  *
  * This function should be called once during system startup.
  * It initializes system components and sets up required configurations.
+ *
+ * With CONFIG_SYSTEM_SNAPSHOT, it also restores the feature states kept over a reset of the LP core.
  */
 void system_setup();
 
+/**
+ * @brief Restore the feature states kept over a reset of the LP core
+ *
+ * The restored values are read with low_code_feature_get() right away, and passed to the feature handlers
+ * by the first system_loop(). Does nothing without CONFIG_SYSTEM_SNAPSHOT.
+ * @note This function is called by system_setup()
+ */
+void system_snapshot_restore();
+
+/**
+ * @brief Pass the restored feature states to the feature handlers, once
+ *
+ * @note This function is called by system_loop()
+ */
+void system_snapshot_replay();
+
+/**
+ * @brief Drop the feature states kept over a reset of the LP core
+ *
+ * This can be used before a factory reset, so that the old states are not restored.
+ */
+void system_snapshot_clear();
+
 /**
  * @brief Update system timers
  *
@@ -79,6 +143,79 @@ void system_setup();
  */
 void system_timer_update();
 
+/**
+ * @brief Post a job to be run by the main loop
+ *
+ * The job runs later from system_loop(), after the messages from the system and the timers have been
+ * handled. Every iteration runs the jobs posted before it, in order, until CONFIG_SYSTEM_JOB_BUDGET_US
+ * is spent; the remaining jobs run in the next iterations. Long work should be split into short steps,
+ * with each step posting the next one, so that it does not delay the messages and the button handling.
+ *
+ * @note This must not be called from an interrupt handler.
+ *
+ * @param fn Job function
+ * @param arg Argument to pass to the job function
+ *
+ * @return
+ *      - 0 on success
+ *      - -1 if fn is NULL or the job queue is full
+ */
+int system_post(system_job_fn_t fn, void *arg);
+
+/**
+ * @brief Run the posted jobs until the budget of the iteration is spent
+ *
+ * @note This function is called by system_loop()
+ */
+void system_run_jobs();
+
+/**
+ * @brief Check whether posted jobs are waiting to run
+ *
+ * @return true if at least one job is waiting
+ */
+bool system_jobs_pending();
+
+/**
+ * @brief Get the deferred job accounting
+ *
+ * @param stats Pointer to the structure to be filled
+ *
+ * @return
+ *      - 0 on success
+ *      - -1 on failure
+ */
+int system_get_job_stats(system_job_stats_t *stats);
+
+/**
+ * @brief Reset the deferred job accounting
+ */
+void system_reset_job_stats();
+
+/**
+ * @brief Wake up the main loop
+ *
+ * This makes the next system_loop() return without waiting for an interrupt. It can be called
+ * from an interrupt handler which has work for the main loop.
+ */
+void system_wakeup();
+
+/**
+ * @brief Get the idle time accounting of the main loop
+ *
+ * @param stats Pointer to the structure to be filled
+ *
+ * @return
+ *      - 0 on success
+ *      - -1 on failure
+ */
+int system_get_idle_stats(system_idle_stats_t *stats);
+
+/**
+ * @brief Reset the idle time accounting of the main loop
+ */
+void system_reset_idle_stats();
+
 /**
  * @brief Put the system to sleep for specified duration
  *
@@ -112,11 +249,36 @@ void system_delay_us(uint32_t us);
 /**
  * @brief Get current system time in milliseconds
  *
- * This is the time since the system was booted.
+ * This is system_clock_ms() truncated to 32 bits, the time since the LP core started. It wraps around after
+ * 49 days, use system_clock_ms() for durations which can be longer.
  * @return uint32_t Current system time in milliseconds
  */
 uint32_t system_get_time();
 
+/**
+ * @brief Get the system clock in LP core cycles
+ *
+ * This is a 64 bit monotonic clock which starts with the LP core and does not wrap around, unlike mcycle
+ * which wraps every 268 s. It is the time base of the software timers and the button driver, and can be
+ * called from interrupt handlers.
+ * @return uint64_t Cycles since the LP core started
+ */
+uint64_t system_clock_cycles();
+
+/**
+ * @brief Get the system clock in microseconds
+ *
+ * @return uint64_t Microseconds since the LP core started, see system_clock_cycles()
+ */
+uint64_t system_clock_us();
+
+/**
+ * @brief Get the system clock in milliseconds
+ *
+ * @return uint64_t Milliseconds since the LP core started, see system_clock_cycles()
+ */
+uint64_t system_clock_ms();
+
 /**
  * @brief Create system timer
  *
@@ -162,6 +324,21 @@ int system_timer_stop(system_timer_handle_t handle);
  */
 int system_timer_delete(system_timer_handle_t handle);
 
+/**
+ * @brief Set the slack of system timer
+ *
+ * The timer may run up to slack_ms after its timeout, so that it runs in the same wakeup as the other timers
+ * whose windows overlap. This saves active periods of the LP core at the cost of timing precision.
+ *
+ * @param handle system_timer_handle_t created using system_timer_create
+ * @param slack_ms Time after the timeout within which the callback may run, less than the period of a periodic timer
+ *
+ * @return
+ *      - 0 on success
+ *      - -1 on failure
+ */
+int system_timer_set_slack(system_timer_handle_t handle, int slack_ms);
+
 /**
  * @brief Enable software interrupt
  *
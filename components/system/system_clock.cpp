@@ -0,0 +1,47 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <riscv/rv_utils.h>
+
+#include <system.h>
+
+/* mcycle extended to 64 bits: the elapsed cycles since the previous read are added, which is correct as long as
+ * the clock is read at least once per mcycle period (268 s). sw_timer reads it on every system_loop(), and the
+ * wait for interrupt is bounded to stay below that. */
+static uint64_t clock_cycles = 0;
+static uint32_t clock_last_tick = 0;
+
+uint64_t system_clock_cycles()
+{
+    /* Also read from interrupt handlers, the previous interrupt state is restored */
+    uint32_t state = RV_CLEAR_CSR(mstatus, MSTATUS_MIE) & MSTATUS_MIE;
+    uint32_t tick = RV_READ_CSR(mcycle);
+    clock_cycles += (uint32_t)(tick - clock_last_tick);
+    clock_last_tick = tick;
+    uint64_t cycles = clock_cycles;
+    if (state) {
+        RV_SET_CSR(mstatus, MSTATUS_MIE);
+    }
+    return cycles;
+}
+
+uint64_t system_clock_us()
+{
+    return system_clock_cycles() / SYSTEM_CLOCK_CYCLES_PER_US;
+}
+
+uint64_t system_clock_ms()
+{
+    return system_clock_cycles() / SYSTEM_CLOCK_CYCLES_PER_MS;
+}
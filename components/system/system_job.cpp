@@ -0,0 +1,112 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sdkconfig.h>
+#include <riscv/rv_utils.h>
+#include <profiler.h>
+
+#include <system.h>
+
+#ifdef CONFIG_SYSTEM_JOB_QUEUE_LEN
+#define SYSTEM_JOB_QUEUE_LEN CONFIG_SYSTEM_JOB_QUEUE_LEN
+#else
+#define SYSTEM_JOB_QUEUE_LEN 16
+#endif /* CONFIG_SYSTEM_JOB_QUEUE_LEN */
+
+#ifdef CONFIG_SYSTEM_JOB_BUDGET_US
+#define SYSTEM_JOB_BUDGET_US CONFIG_SYSTEM_JOB_BUDGET_US
+#else
+#define SYSTEM_JOB_BUDGET_US 1000
+#endif /* CONFIG_SYSTEM_JOB_BUDGET_US */
+
+#define SYSTEM_JOB_BUDGET_CYCLES ((uint32_t)SYSTEM_JOB_BUDGET_US * SYSTEM_CLOCK_CYCLES_PER_US)
+
+typedef struct {
+    system_job_fn_t fn;
+    void *arg;
+} system_job_t;
+
+static const char *TAG = "system_job";
+
+/* Ring of posted jobs, the oldest is at job_head */
+static system_job_t job_queue[SYSTEM_JOB_QUEUE_LEN];
+static uint16_t job_head = 0;
+static uint16_t job_count = 0;
+static system_job_stats_t job_stats;
+
+int system_post(system_job_fn_t fn, void *arg)
+{
+    if (!fn) {
+        return -1;
+    }
+    if (job_count >= SYSTEM_JOB_QUEUE_LEN) {
+        job_stats.post_failures++;
+        printf("%s: Job queue full\n", TAG);
+        return -1;
+    }
+    system_job_t *job = &job_queue[(job_head + job_count) % SYSTEM_JOB_QUEUE_LEN];
+    job->fn = fn;
+    job->arg = arg;
+    job_count++;
+    if (job_count > job_stats.queue_hwm) {
+        job_stats.queue_hwm = job_count;
+    }
+    return 0;
+}
+
+bool system_jobs_pending()
+{
+    return job_count > 0;
+}
+
+void system_run_jobs()
+{
+    /* Only the jobs queued before this call run now. A job which posts itself again to continue its work
+     * runs in the next iteration, after the messages and timers have been handled. */
+    uint16_t remaining = job_count;
+    if (remaining == 0) {
+        return;
+    }
+
+    uint32_t start_tick = RV_READ_CSR(mcycle);
+    do {
+        system_job_t job = job_queue[job_head];
+        job_head = (job_head + 1) % SYSTEM_JOB_QUEUE_LEN;
+        job_count--;
+        remaining--;
+        PROFILER_CALLBACK(PROFILER_CALLBACK_JOB, job.fn, job.fn(job.arg));
+        job_stats.run_count++;
+    } while (remaining > 0 && (uint32_t)(RV_READ_CSR(mcycle) - start_tick) < SYSTEM_JOB_BUDGET_CYCLES);
+
+    if (remaining > 0) {
+        job_stats.budget_exhausted++;
+    }
+}
+
+int system_get_job_stats(system_job_stats_t *stats)
+{
+    if (!stats) {
+        return -1;
+    }
+    *stats = job_stats;
+    return 0;
+}
+
+void system_reset_job_stats()
+{
+    memset(&job_stats, 0, sizeof(job_stats));
+}
@@ -0,0 +1,208 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sdkconfig.h>
+#include <low_code.h>
+
+#include <system.h>
+
+#if CONFIG_SYSTEM_SNAPSHOT
+
+#ifdef CONFIG_SYSTEM_SNAPSHOT_MAX_FEATURES
+#define SYSTEM_SNAPSHOT_MAX_FEATURES CONFIG_SYSTEM_SNAPSHOT_MAX_FEATURES
+#else
+#define SYSTEM_SNAPSHOT_MAX_FEATURES 8
+#endif /* CONFIG_SYSTEM_SNAPSHOT_MAX_FEATURES */
+
+/* Values longer than this are not kept by low_code either */
+#ifdef CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE
+#define SYSTEM_SNAPSHOT_VALUE_SIZE CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE
+#else
+#define SYSTEM_SNAPSHOT_VALUE_SIZE 8
+#endif /* CONFIG_LOW_CODE_FEATURE_STATE_VALUE_SIZE */
+
+#define SNAPSHOT_MAGIC 0x4C43534E /* "LCSN" */
+
+/* A snapshot written by a build with another layout is not restored */
+#define SNAPSHOT_LAYOUT ((SYSTEM_SNAPSHOT_MAX_FEATURES << 16) | sizeof(snapshot_slot_t))
+
+static_assert(SYSTEM_SNAPSHOT_MAX_FEATURES <= 32, "snapshot slot masks are 32 bit");
+
+typedef struct {
+    uint32_t check;                 /* snapshot_slot_check() of the slot, a slot which does not match is empty */
+    uint16_t endpoint_id;
+    uint8_t type;
+    uint8_t value_len;
+    low_code_feature_id_t feature_id;
+    uint8_t value[SYSTEM_SNAPSHOT_VALUE_SIZE];
+} snapshot_slot_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;
+    snapshot_slot_t slots[SYSTEM_SNAPSHOT_MAX_FEATURES];
+} snapshot_t;
+
+static const char *TAG = "system_snapshot";
+
+/* Not zeroed at startup, so that it keeps its content over a reset of the LP core. Every slot has its own
+ * check, so a reset while a slot is written only loses that slot. */
+static snapshot_t snapshot __attribute__((section(".noinit")));
+
+/* Slots in use, rebuilt from the checks by system_snapshot_restore() */
+static uint32_t snapshot_slots_used = 0;
+static bool snapshot_replay_pending = false;
+
+/* FNV-1a of the slot after the check */
+static uint32_t snapshot_slot_check(const snapshot_slot_t *slot)
+{
+    const uint8_t *data = (const uint8_t *)slot + sizeof(slot->check);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(*slot) - sizeof(slot->check); i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void snapshot_slot_to_feature(snapshot_slot_t *slot, low_code_feature_data_t *data)
+{
+    memset(data, 0, sizeof(*data));
+    data->details.endpoint_id = slot->endpoint_id;
+    data->details.feature_id = slot->feature_id;
+    data->value.type = (low_code_feature_value_type_t)slot->type;
+    data->value.value_len = slot->value_len;
+    data->value.value = slot->value;
+}
+
+static int snapshot_slot_find(uint16_t endpoint_id, low_code_feature_id_t feature_id)
+{
+    uint32_t mask = snapshot_slots_used;
+    while (mask) {
+        int i = __builtin_ctz(mask);
+        if (snapshot.slots[i].endpoint_id == endpoint_id && snapshot.slots[i].feature_id == feature_id) {
+            return i;
+        }
+        mask &= mask - 1;
+    }
+    return -1;
+}
+
+/* Called by low_code whenever the last known value of a feature changes */
+static void snapshot_record(const low_code_feature_data_t *data)
+{
+    int i = snapshot_slot_find(data->details.endpoint_id, data->details.feature_id);
+
+    if (data->value.value_len > SYSTEM_SNAPSHOT_VALUE_SIZE) {
+        /* The value is not known anymore */
+        if (i >= 0) {
+            snapshot.slots[i].check = ~snapshot.slots[i].check;
+            snapshot_slots_used &= ~(1UL << i);
+        }
+        return;
+    }
+
+    if (i < 0) {
+        uint32_t free_slots = ~snapshot_slots_used & (uint32_t)((1ULL << SYSTEM_SNAPSHOT_MAX_FEATURES) - 1);
+        if (!free_slots) {
+            return;
+        }
+        i = __builtin_ctz(free_slots);
+        snapshot_slots_used |= 1UL << i;
+    }
+
+    snapshot_slot_t *slot = &snapshot.slots[i];
+    slot->endpoint_id = data->details.endpoint_id;
+    slot->feature_id = data->details.feature_id;
+    slot->type = data->value.type;
+    slot->value_len = data->value.value_len;
+    memset(slot->value, 0, sizeof(slot->value));
+    memcpy(slot->value, data->value.value, data->value.value_len);
+    slot->check = snapshot_slot_check(slot);
+}
+
+void system_snapshot_restore()
+{
+    snapshot_slots_used = 0;
+
+    if (snapshot.magic != SNAPSHOT_MAGIC || snapshot.layout != SNAPSHOT_LAYOUT) {
+        /* First start after loading the LP core binary, or another build */
+        memset(&snapshot, 0, sizeof(snapshot));
+        snapshot.magic = SNAPSHOT_MAGIC;
+        snapshot.layout = SNAPSHOT_LAYOUT;
+    } else {
+        int restored = 0;
+        for (int i = 0; i < SYSTEM_SNAPSHOT_MAX_FEATURES; i++) {
+            snapshot_slot_t *slot = &snapshot.slots[i];
+            if (slot->check != snapshot_slot_check(slot) || slot->type == LOW_CODE_VALUE_TYPE_INVALID ||
+                    slot->value_len > SYSTEM_SNAPSHOT_VALUE_SIZE || snapshot_slot_find(slot->endpoint_id, slot->feature_id) >= 0) {
+                continue;
+            }
+            low_code_feature_data_t data;
+            snapshot_slot_to_feature(slot, &data);
+            low_code_feature_state_restore(&data);
+            snapshot_slots_used |= 1UL << i;
+            restored++;
+        }
+        if (restored) {
+            printf("%s: Restored %d feature states\n", TAG, restored);
+            snapshot_replay_pending = true;
+        }
+    }
+
+    low_code_set_feature_state_callback(snapshot_record);
+}
+
+void system_snapshot_replay()
+{
+    if (!snapshot_replay_pending) {
+        return;
+    }
+    snapshot_replay_pending = false;
+
+    uint32_t mask = snapshot_slots_used;
+    while (mask) {
+        low_code_feature_data_t data;
+        snapshot_slot_to_feature(&snapshot.slots[__builtin_ctz(mask)], &data);
+        low_code_feature_update_from_transport(&data);
+        mask &= mask - 1;
+    }
+}
+
+void system_snapshot_clear()
+{
+    for (int i = 0; i < SYSTEM_SNAPSHOT_MAX_FEATURES; i++) {
+        snapshot.slots[i].check = ~snapshot_slot_check(&snapshot.slots[i]);
+    }
+    snapshot_slots_used = 0;
+    snapshot_replay_pending = false;
+}
+
+#else
+
+void system_snapshot_restore()
+{
+}
+
+void system_snapshot_replay()
+{
+}
+
+void system_snapshot_clear()
+{
+}
+
+#endif /* CONFIG_SYSTEM_SNAPSHOT */
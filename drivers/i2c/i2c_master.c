@@ -16,6 +16,7 @@
 #include <ulp_lp_core_interrupts.h>
 
 #include <esp_err.h>
+#include <system.h>
 
 #include "i2c_master.h"
 
@@ -69,10 +70,10 @@ static void i2c_format_cmd(i2c_dev_t *dev, uint32_t cmd_idx, uint8_t op_code, ui
     i2c_ll_master_write_cmd_reg(dev, hw_cmd, cmd_idx);
 }
 
-static inline int i2c_wait_for_interrupt(i2c_dev_t *dev, uint32_t intr_mask, int32_t ticks_to_wait)
+static inline int i2c_wait_for_interrupt(i2c_dev_t *dev, uint32_t intr_mask, int32_t timeout_ms)
 {
     uint32_t intr_status = 0;
-    uint32_t to = 0;
+    uint64_t start = system_clock_cycles();
     while (1) {
         i2c_ll_get_intr_mask(dev, &intr_status);
         if (intr_status & intr_mask) {
@@ -100,13 +101,11 @@ static inline int i2c_wait_for_interrupt(i2c_dev_t *dev, uint32_t intr_mask, int
             break;
         }
 
-        if (ticks_to_wait > -1) {
-            /* If the ticks_to_wait value is not -1, keep track of ticks and
-             * break from the loop once the timeout is reached.
+        if (timeout_ms > -1) {
+            /* If the timeout_ms value is not -1, break from the loop once
+             * that much time has elapsed since the wait started.
              */
-            ulp_lp_core_delay_cycles(1);
-            to++;
-            if (to >= ticks_to_wait) {
+            if (system_clock_cycles() - start >= (uint64_t)timeout_ms * SYSTEM_CLOCK_CYCLES_PER_MS) {
                 /* Disable and clear interrupt bits */
                 i2c_ll_disable_intr_mask(dev, intr_mask);
                 i2c_ll_clear_intr_mask(dev, intr_mask);
@@ -140,7 +139,7 @@ static inline void i2c_config_device_addr(i2c_dev_t *dev, uint32_t cmd_idx, uint
 
 int i2c_master_read_from_device(int i2c_port, uint16_t device_addr,
                                               uint8_t *data_rd, size_t size,
-                                              int32_t ticks_to_wait)
+                                              int32_t timeout_ms)
 {
 
     /* Configure I2C port */
@@ -222,7 +221,7 @@ int i2c_master_read_from_device(int i2c_port, uint16_t device_addr,
         i2c_ll_master_trans_start(dev);
 
         /* Wait for the transfer to complete */
-        ret = i2c_wait_for_interrupt(dev, intr_mask, ticks_to_wait);
+        ret = i2c_wait_for_interrupt(dev, intr_mask, timeout_ms);
         if (ret != ESP_OK) {
             /* Transaction error. Abort. */
             goto exit;
@@ -244,7 +243,7 @@ exit:
 
 int i2c_master_write_to_device(int i2c_port, uint16_t device_addr,
                                              const uint8_t *data_wr, size_t size,
-                                             int32_t ticks_to_wait)
+                                             int32_t timeout_ms)
 { 
     /* Configure I2C port */
     if (i2c_port >= SOC_I2C_NUM) {
@@ -330,7 +329,7 @@ int i2c_master_write_to_device(int i2c_port, uint16_t device_addr,
         ulp_lp_core_delay_us(10000);
 
         /* Wait for the transfer to complete */
-        ret = i2c_wait_for_interrupt(dev, intr_mask, ticks_to_wait);
+        ret = i2c_wait_for_interrupt(dev, intr_mask, timeout_ms);
         if (ret != ESP_OK) {
             /* Transaction error. Abort. */
             goto exit;
@@ -352,7 +351,7 @@ exit:
 int i2c_master_write_read_device(int i2c_port, uint16_t device_addr,
                                                const uint8_t *data_wr, size_t write_size,
                                                uint8_t *data_rd, size_t read_size,
-                                               int32_t ticks_to_wait)
+                                               int32_t timeout_ms)
 {
     if ((write_size == 0) || (read_size == 0)) {
         // Quietly return
@@ -361,12 +360,12 @@ int i2c_master_write_read_device(int i2c_port, uint16_t device_addr,
 
     esp_err_t ret = ESP_OK;
 
-    ret = i2c_master_write_to_device(i2c_port, device_addr, data_wr, write_size, ticks_to_wait);
+    ret = i2c_master_write_to_device(i2c_port, device_addr, data_wr, write_size, timeout_ms);
     if (ret != ESP_OK) {
         printf("%s: failed to write to device\n", TAG);
         return ret;
     }
-    ret = i2c_master_read_from_device(i2c_port, device_addr, data_rd, read_size, ticks_to_wait);
+    ret = i2c_master_read_from_device(i2c_port, device_addr, data_rd, read_size, timeout_ms);
     if (ret != ESP_OK) {
         printf("%s: failed to read from device\n", TAG);
         return ret;
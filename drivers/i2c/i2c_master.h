@@ -25,7 +25,7 @@ extern "C" {
  * @param device_addr       I2C device address (7-bit)
  * @param data_rd           Buffer to hold data to be read
  * @param size              Size of data to be read in bytes
- * @param ticks_to_wait     Operation timeout in CPU cycles. Set to -1 to wait forever.
+ * @param timeout_ms        Operation timeout in milliseconds. Set to -1 to wait forever.
  *
  * @return
  *      - 0 on success
@@ -35,7 +35,7 @@ extern "C" {
  */
 int i2c_master_read_from_device(int i2c_port, uint16_t device_addr,
                                               uint8_t *data_rd, size_t size,
-                                              int32_t ticks_to_wait);
+                                              int32_t timeout_ms);
 
 /**
  * @brief Write to I2C device
@@ -44,7 +44,7 @@ int i2c_master_read_from_device(int i2c_port, uint16_t device_addr,
  * @param device_addr       I2C device address (7-bit)
  * @param data_wr           Buffer which holds the data to be written
  * @param size              Size of data to be written in bytes
- * @param ticks_to_wait     Operation timeout in CPU cycles. Set to -1 to wait forever.
+ * @param timeout_ms        Operation timeout in milliseconds. Set to -1 to wait forever.
  *
  * @return
  *      - 0 on success
@@ -54,7 +54,7 @@ int i2c_master_read_from_device(int i2c_port, uint16_t device_addr,
  */
 int i2c_master_write_to_device(int i2c_port, uint16_t device_addr,
                                              const uint8_t *data_wr, size_t size,
-                                             int32_t ticks_to_wait);
+                                             int32_t timeout_ms);
 
 /**
  * @brief Write to and then read from an I2C device in a single transaction
@@ -65,7 +65,7 @@ int i2c_master_write_to_device(int i2c_port, uint16_t device_addr,
  * @param write_size        Size of data to be written in bytes
  * @param data_rd           Buffer to hold data to be read
  * @param read_size         Size of data to be read in bytes
- * @param ticks_to_wait     Operation timeout in CPU cycles. Set to -1 to wait forever.
+ * @param timeout_ms        Operation timeout in milliseconds. Set to -1 to wait forever.
  *
  * @return
  *      - 0 on success
@@ -75,7 +75,7 @@ int i2c_master_write_to_device(int i2c_port, uint16_t device_addr,
 int i2c_master_write_read_device(int i2c_port, uint16_t device_addr,
                                                const uint8_t *data_wr, size_t write_size,
                                                uint8_t *data_rd, size_t read_size,
-                                               int32_t ticks_to_wait);
+                                               int32_t timeout_ms);
 
 /**
  * @brief Init i2c master
@@ -24,6 +24,7 @@
 #include <ulp_lp_core_utils.h>
 
 #include <esp_amp_platform.h>
+#include <system.h>
 
 #include "uart.h"
 
@@ -56,13 +57,11 @@ static inline void gpio_matrix_out(int gpio_num, uint32_t signal_idx, bool out_i
     GPIO.func_out_sel_cfg[gpio_num].val = reg.val;
 }
 
-static esp_err_t lp_core_uart_check_timeout(uart_hal_context_t hal, uint32_t intr_mask, int32_t timeout, uint32_t *ticker)
+static esp_err_t lp_core_uart_check_timeout(uart_hal_context_t hal, uint32_t intr_mask, int32_t timeout_ms, uint64_t start)
 {
-    if (timeout > -1) {
-        /* If the timeout value is not -1, delay for 1 CPU cycle and keep track of ticks */
-        ulp_lp_core_delay_cycles(1);
-        *ticker = *ticker + 1;
-        if (*ticker >= timeout) {
+    if (timeout_ms > -1) {
+        /* If the timeout value is not -1, check the time elapsed since the operation started */
+        if (system_clock_cycles() - start >= (uint64_t)timeout_ms * SYSTEM_CLOCK_CYCLES_PER_MS) {
             /* Disable and clear interrupt bits */
             uart_hal_disable_intr_mask(&hal, intr_mask);
             uart_hal_clr_intsts_mask(&hal, intr_mask);
@@ -243,7 +242,7 @@ esp_err_t uart_init(uart_port_t uart_port, uart_cfg_t cfg)
     return ESP_OK;
 }
 
-esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, int32_t timeout)
+esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, int32_t timeout_ms)
 {
     if (size > UART_HW_FIFO_LEN(uart_num)) {
         printf("%s: write failed, data buffer size exceeds fifo limit\n", TAG);
@@ -277,7 +276,7 @@ esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, i
     int32_t remaining_bytes = size;
     esp_err_t ret = ESP_OK;
     uint32_t intr_status = 0;
-    uint32_t to = 0;
+    uint64_t start = system_clock_cycles();
 
     while (remaining_bytes > 0) {
         /* Write to the Tx FIFO */
@@ -301,7 +300,7 @@ esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, i
                 }
 
                 /* Check for transaction timeout */
-                ret = lp_core_uart_check_timeout(hal, intr_mask, timeout, &to);
+                ret = lp_core_uart_check_timeout(hal, intr_mask, timeout_ms, start);
                 if (ret == ESP_ERR_TIMEOUT) {
                     /* Timeout */
                     uart_hal_disable_intr_mask(&hal, intr_mask);
@@ -315,7 +314,7 @@ esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, i
             remaining_bytes -= tx_len;
         } else {
             /* Tx FIFO does not have empty slots. Check for transaction timeout */
-            ret = lp_core_uart_check_timeout(hal, intr_mask, timeout, &to);
+            ret = lp_core_uart_check_timeout(hal, intr_mask, timeout_ms, start);
             if (ret == ESP_ERR_TIMEOUT) {
                 /* Timeout */
                 uart_hal_disable_intr_mask(&hal, intr_mask);
@@ -331,7 +330,7 @@ esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, i
     return ret;
 }
 
-int uart_read_bytes(uart_port_t uart_num, void *buf, size_t size, int32_t timeout)
+int uart_read_bytes(uart_port_t uart_num, void *buf, size_t size, int32_t timeout_ms)
 {
     if (size > UART_HW_FIFO_LEN(uart_num)) {
         printf("%s: read failed, data buffer size exceeds fifo limit\n", TAG);
@@ -368,7 +367,7 @@ int uart_read_bytes(uart_port_t uart_num, void *buf, size_t size, int32_t timeou
     int32_t remaining_bytes = size;
     esp_err_t ret = ESP_OK;
     uint32_t intr_status = 0;
-    uint32_t to = 0;
+    uint64_t start = system_clock_cycles();
 
     while (remaining_bytes > 0) {
         /* Read from the Rx FIFO
@@ -405,7 +404,7 @@ int uart_read_bytes(uart_port_t uart_num, void *buf, size_t size, int32_t timeou
             remaining_bytes -= rx_len;
         } else {
             /* We have no data to read from the Rx FIFO. Check for transaction timeout */
-            ret = lp_core_uart_check_timeout(hal, intr_mask, timeout, &to);
+            ret = lp_core_uart_check_timeout(hal, intr_mask, timeout_ms, start);
             if (ret == ESP_ERR_TIMEOUT) {
                 break;
             }
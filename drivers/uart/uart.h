@@ -62,31 +62,31 @@ esp_err_t uart_init(uart_port_t uart_num, uart_cfg_t cfg);
 /**
  * @brief Read data from the UART port
  *
- * This function will read data from the Rx FIFO. If a timeout value is configured, then this function will timeout once the number of CPU cycles expire.
+ * This function will read data from the Rx FIFO. If a timeout value is configured, then this function will timeout once that time has elapsed.
  *
  * @param uart_num      UART port number
  * @param buf           data buffer address
  * @param size          data length to send
- * @param timeout       Operation timeout in CPU cycles. Set to -1 to wait forever.
+ * @param timeout_ms    Operation timeout in milliseconds. Set to -1 to wait forever.
  *
  * @return              - (-1) Error
  *                      - OTHERS (>=0) The number of bytes read from the Rx FIFO
  */
-int uart_read_bytes(uart_port_t uart_num, void *buf, size_t size, int32_t timeout);
+int uart_read_bytes(uart_port_t uart_num, void *buf, size_t size, int32_t timeout_ms);
 
 /**
  * @brief Write data to the UART port
  *
- * This function will write data to the Tx FIFO. If a timeout value is configured, this function will timeout once the number of CPU cycles expire.
+ * This function will write data to the Tx FIFO. If a timeout value is configured, this function will timeout once that time has elapsed.
  *
  * @param uart_num      UART port number
  * @param src           data buffer address
  * @param size          data length to send
- * @param timeout       Operation timeout in CPU cycles. Set to -1 to wait forever.
+ * @param timeout_ms    Operation timeout in milliseconds. Set to -1 to wait forever.
  *
  * @return esp_err_t    ESP_OK when successful
  */
-esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, int32_t timeout);
+esp_err_t uart_write_bytes(uart_port_t uart_num, const void *src, size_t size, int32_t timeout_ms);
 
 #ifdef __cplusplus
 }
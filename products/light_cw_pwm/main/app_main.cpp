@@ -16,6 +16,7 @@
 
 #include <system.h>
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include "app_priv.h"
 
@@ -45,15 +46,15 @@ int feature_update_from_system(low_code_feature_data_t *data)
 
     if (endpoint_id == 1) {
         if (feature_id == LOW_CODE_FEATURE_ID_POWER) {  // Power
-            bool power_value = *(bool *)data->value.value;
+            bool power_value = low_code::feature_value<LOW_CODE_FEATURE_ID_POWER>(data);
             printf("%s: Feature update: power: %d\n", TAG, power_value);
             app_driver_set_light_state(power_value);
         } else if (feature_id == LOW_CODE_FEATURE_ID_BRIGHTNESS) {  // Brightness
-            uint8_t brightness = *(uint8_t *)data->value.value;
+            uint8_t brightness = low_code::feature_value<LOW_CODE_FEATURE_ID_BRIGHTNESS>(data);
             printf("%s: Feature update: brightness: %d\n", TAG, brightness);
             app_driver_set_light_brightness(brightness);
         } else if (feature_id == LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE) {  // Color temperature
-            uint16_t color_temp = *(uint16_t *)data->value.value;
+            uint16_t color_temp = low_code::feature_value<LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE>(data);
             printf("%s: Feature update: color temperature: %d\n", TAG, color_temp);
             app_driver_set_light_temperature(color_temp);
         }
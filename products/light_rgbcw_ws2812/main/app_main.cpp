@@ -16,6 +16,7 @@
 
 #include <system.h>
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include "app_priv.h"
 
@@ -26,6 +27,13 @@ static void setup()
     /* Register callbacks */
     low_code_register_callbacks(feature_update_from_system, event_from_system);
 
+    /* Register feature handlers */
+    low_code_register_feature_handler(1, LOW_CODE_FEATURE_ID_POWER, light_power_update_from_system);
+    low_code_register_feature_handler(1, LOW_CODE_FEATURE_ID_BRIGHTNESS, light_brightness_update_from_system);
+    low_code_register_feature_handler(1, LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE, light_temperature_update_from_system);
+    low_code_register_feature_handler(1, LOW_CODE_FEATURE_ID_HUE, light_hue_update_from_system);
+    low_code_register_feature_handler(1, LOW_CODE_FEATURE_ID_SATURATION, light_saturation_update_from_system);
+
     /* Initialize driver */
     app_driver_init();
 }
@@ -37,36 +45,44 @@ static void loop()
     low_code_get_event_from_system();
 }
 
-int feature_update_from_system(low_code_feature_data_t *data)
+int light_power_update_from_system(low_code_feature_data_t *data)
 {
-    /* Get the device feature updates */
-    uint16_t endpoint_id = data->details.endpoint_id;
-    uint32_t feature_id = data->details.feature_id;
-
-    if (endpoint_id == 1) {
-        if (feature_id == LOW_CODE_FEATURE_ID_POWER) {  // Power
-            bool power_value = *(bool *)data->value.value;
-            printf("%s: Feature update: power: %d\n", TAG, power_value);
-            app_driver_set_light_state(power_value);
-        } else if (feature_id == LOW_CODE_FEATURE_ID_BRIGHTNESS) {  // Brightness
-            uint8_t brightness = *(uint8_t *)data->value.value;
-            printf("%s: Feature update: brightness: %d\n", TAG, brightness);
-            app_driver_set_light_brightness(brightness);
-        } else if (feature_id == LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE) {  // Color temperature
-            uint16_t color_temp = *(uint16_t *)data->value.value;
-            printf("%s: Feature update: color temperature: %d\n", TAG, color_temp);
-            app_driver_set_light_temperature(color_temp);
-        } else if (feature_id == LOW_CODE_FEATURE_ID_HUE) {  // Hue
-            uint8_t hue = *(uint8_t *)data->value.value;
-            printf("%s: Feature update: hue: %d\n", TAG, hue);
-            app_driver_set_light_hue(hue);
-        } else if (feature_id == LOW_CODE_FEATURE_ID_SATURATION) {  // Saturation
-            uint8_t saturation = *(uint8_t *)data->value.value;
-            printf("%s: Feature update: saturation: %d\n", TAG, saturation);
-            app_driver_set_light_saturation(saturation);
-        }
-    }
+    bool power_value = low_code::feature_value<LOW_CODE_FEATURE_ID_POWER>(data);
+    printf("%s: Feature update: power: %d\n", TAG, power_value);
+    return app_driver_set_light_state(power_value);
+}
+
+int light_brightness_update_from_system(low_code_feature_data_t *data)
+{
+    uint8_t brightness = low_code::feature_value<LOW_CODE_FEATURE_ID_BRIGHTNESS>(data);
+    printf("%s: Feature update: brightness: %d\n", TAG, brightness);
+    return app_driver_set_light_brightness(brightness);
+}
+
+int light_temperature_update_from_system(low_code_feature_data_t *data)
+{
+    uint16_t color_temp = low_code::feature_value<LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE>(data);
+    printf("%s: Feature update: color temperature: %d\n", TAG, color_temp);
+    return app_driver_set_light_temperature(color_temp);
+}
 
+int light_hue_update_from_system(low_code_feature_data_t *data)
+{
+    uint8_t hue = low_code::feature_value<LOW_CODE_FEATURE_ID_HUE>(data);
+    printf("%s: Feature update: hue: %d\n", TAG, hue);
+    return app_driver_set_light_hue(hue);
+}
+
+int light_saturation_update_from_system(low_code_feature_data_t *data)
+{
+    uint8_t saturation = low_code::feature_value<LOW_CODE_FEATURE_ID_SATURATION>(data);
+    printf("%s: Feature update: saturation: %d\n", TAG, saturation);
+    return app_driver_set_light_saturation(saturation);
+}
+
+int feature_update_from_system(low_code_feature_data_t *data)
+{
+    /* Feature updates which do not have a registered handler are ignored */
     return 0;
 }
 
@@ -29,5 +29,10 @@ int app_driver_set_light_saturation(uint8_t saturation);
 int app_driver_event_handler(low_code_event_t *event);
 
 /* Callbacks from system */
+int light_power_update_from_system(low_code_feature_data_t *data);
+int light_brightness_update_from_system(low_code_feature_data_t *data);
+int light_temperature_update_from_system(low_code_feature_data_t *data);
+int light_hue_update_from_system(low_code_feature_data_t *data);
+int light_saturation_update_from_system(low_code_feature_data_t *data);
 int feature_update_from_system(low_code_feature_data_t *data);
 int event_from_system(low_code_event_t *event);
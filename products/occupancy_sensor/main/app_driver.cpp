@@ -152,6 +152,8 @@ int app_driver_init()
         return -1;
     }
 
+    /* The read may run up to 200 ms late, to share the wakeup with other timers */
+    system_timer_set_slack(timer, 200);
     system_timer_start(timer);
 
     return 0;
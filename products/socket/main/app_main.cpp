@@ -16,6 +16,7 @@
 
 #include <system.h>
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include "app_priv.h"
 
@@ -45,7 +46,7 @@ int feature_update_from_system(low_code_feature_data_t *data)
 
     if (endpoint_id == 1) {
         if (feature_id == LOW_CODE_FEATURE_ID_POWER) {  // Power
-            bool power_value = *(bool *)data->value.value;
+            bool power_value = low_code::feature_value<LOW_CODE_FEATURE_ID_POWER>(data);
             printf("%s: Feature update: power: %d\n", TAG, power_value);
             return app_driver_set_socket_state(power_value);
         }
@@ -14,8 +14,10 @@
 
 #include <stdio.h>
 
+#include <sdkconfig.h>
 #include <system.h>
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include <button_driver.h>
 #include <relay_driver.h>
@@ -29,32 +31,32 @@
 #define RELAY2_GPIO_NUM ((gpio_num_t)3)
 #define INDICATOR_GPIO_NUM ((gpio_num_t)8)
 
+#if defined(CONFIG_LOW_CODE_MAX_FEATURE_STATES) && CONFIG_LOW_CODE_MAX_FEATURE_STATES == 0
+#error "The socket states are kept in the low_code feature state table, CONFIG_LOW_CODE_MAX_FEATURE_STATES must not be 0"
+#endif
+
 static const char *TAG = "app_driver";
 
-static bool socket_states[2] = {false, false};
+/* The socket states are the last power values kept by low_code, off until the first update */
+static bool app_driver_get_socket_state(uint16_t endpoint_id)
+{
+    bool state = false;
+    low_code::feature_get<LOW_CODE_FEATURE_ID_POWER>(endpoint_id, &state);
+    return state;
+}
 
 static void app_driver_toggle_socket_state_button_callback(void *arg, void *data)
 {
     uint8_t endpoint_id = (uint8_t)(uintptr_t)data;
-    uint8_t socket_index = endpoint_id - 1;
+    bool state = !app_driver_get_socket_state(endpoint_id);
 
-    socket_states[socket_index] = !socket_states[socket_index];
-    printf("%s: Set socket %d state to %d\n", TAG, endpoint_id, socket_states[socket_index]);
-    app_driver_set_socket_state(endpoint_id, socket_states[socket_index]);
+    printf("%s: Set socket %d state to %d\n", TAG, endpoint_id, state);
 
-    low_code_feature_data_t update_data = {
-        .details = {
-            .endpoint_id = endpoint_id,
-            .feature_id = LOW_CODE_FEATURE_ID_POWER
-        },
-        .value = {
-            .type = LOW_CODE_VALUE_TYPE_BOOLEAN,
-            .value_len = sizeof(bool),
-            .value = (uint8_t*)&socket_states[socket_index],
-        },
-    };
+    /* This also records the new state */
+    auto update = low_code::make_feature<LOW_CODE_FEATURE_ID_POWER>(endpoint_id, state);
+    low_code_feature_update_to_system(&update.data);
 
-    low_code_feature_update_to_system(&update_data);
+    app_driver_set_socket_state(endpoint_id, state);
 }
 
 static void app_driver_trigger_factory_reset_button_callback(void *arg, void *data)
@@ -121,7 +123,7 @@ int app_driver_init()
     light_driver_init(&cfg);
 
     /* Set initial LED states */
-    light_driver_set_power(socket_states[0] || socket_states[1]);
+    light_driver_set_power(app_driver_get_socket_state(1) || app_driver_get_socket_state(2));
 
     printf("%s: App driver initialized\n", TAG);
     return 0;
@@ -129,15 +131,14 @@ int app_driver_init()
 
 int app_driver_set_socket_state(uint16_t endpoint_id, bool state)
 {
-    uint8_t socket_index = endpoint_id - 1;
-    socket_states[socket_index] = state;
     printf("%s: Set socket %d state to %d\n", TAG, endpoint_id, state);
 
     /* Set appropriate relay */
     gpio_num_t relay_gpio = (endpoint_id == 1) ? RELAY1_GPIO_NUM : RELAY2_GPIO_NUM;
     relay_driver_set_power(relay_gpio, state);
 
-    bool any_socket_on = socket_states[0] || socket_states[1];
+    /* Called with the state of endpoint_id already recorded by low_code */
+    bool any_socket_on = app_driver_get_socket_state(1) || app_driver_get_socket_state(2);
     light_driver_set_power(any_socket_on);
 
     return 0;
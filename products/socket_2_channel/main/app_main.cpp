@@ -16,6 +16,7 @@
 
 #include <system.h>
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include "app_priv.h"
 
@@ -26,6 +27,10 @@ static void setup()
     /* Register callbacks */
     low_code_register_callbacks(feature_update_from_system, event_from_system);
 
+    /* Register feature handlers for both the sockets */
+    low_code_register_feature_handler(1, LOW_CODE_FEATURE_ID_POWER, socket_power_update_from_system);
+    low_code_register_feature_handler(2, LOW_CODE_FEATURE_ID_POWER, socket_power_update_from_system);
+
     /* Initialize driver */
     app_driver_init();
 }
@@ -37,20 +42,17 @@ static void loop()
     low_code_get_event_from_system();
 }
 
-int feature_update_from_system(low_code_feature_data_t *data)
+int socket_power_update_from_system(low_code_feature_data_t *data)
 {
-    /* Get the feature updates */
     uint16_t endpoint_id = data->details.endpoint_id;
-    uint32_t feature_id = data->details.feature_id;
-
-    if (endpoint_id == 1 || endpoint_id == 2) {
-        if (feature_id == LOW_CODE_FEATURE_ID_POWER) {  // Power
-            bool power_value = *(bool *)data->value.value;
-            printf("%s: Feature update: socket %d power: %d\n", TAG, endpoint_id, power_value);
-            return app_driver_set_socket_state(endpoint_id, power_value);
-        }
-    }
+    bool power_value = low_code::feature_value<LOW_CODE_FEATURE_ID_POWER>(data);
+    printf("%s: Feature update: socket %d power: %d\n", TAG, endpoint_id, power_value);
+    return app_driver_set_socket_state(endpoint_id, power_value);
+}
 
+int feature_update_from_system(low_code_feature_data_t *data)
+{
+    /* Feature updates which do not have a registered handler are ignored */
     return 0;
 }
 
@@ -25,5 +25,6 @@ int app_driver_set_socket_state(uint16_t endpoint_id, bool state);
 int app_driver_event_handler(low_code_event_t *event);
 
 /* Callbacks from system */
+int socket_power_update_from_system(low_code_feature_data_t *data);
 int feature_update_from_system(low_code_feature_data_t *data);
 int event_from_system(low_code_event_t *event);
@@ -130,6 +130,18 @@ int app_driver_init()
         return -1;
     }
 
+    /*
+     * Only report the temperature when it changes by 0.1 degree (it is reported in 0.01 degree),
+     * but at least every 5 minutes.
+     */
+    low_code_report_config_t report_cfg = {
+        .absolute = 10,
+        .relative = 0,
+        .min_interval_ms = 0,
+        .max_interval_ms = 5 * 60 * 1000,
+    };
+    low_code_set_report_config(1, LOW_CODE_FEATURE_ID_TEMPERATURE_SENSOR_VALUE, &report_cfg);
+
     /*
      * Create a timer that will call `app_driver_read_and_report_feature`
      * periodically every 10 sec.
@@ -140,6 +152,8 @@ int app_driver_init()
         return -1;
     }
 
+    /* The read may run up to 1 sec late, to share the wakeup with other timers */
+    system_timer_set_slack(timer, 1000);
     system_timer_start(timer);
 
     return 0;
@@ -179,6 +179,8 @@ int app_driver_init()
         return -1;
     }
 
+    /* The read may run up to 1 sec late, to share the wakeup with other timers */
+    system_timer_set_slack(timer, 1000);
     system_timer_start(timer);
 
     return 0;
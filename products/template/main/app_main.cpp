@@ -16,6 +16,7 @@
 
 #include <system.h> // Provides system_digital_write and pin_level_t enum
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include "app_priv.h"
 
@@ -110,7 +111,7 @@ int feature_update_from_system(low_code_feature_data_t *data)
     if (endpoint_id == 1) {
         // Check for the Power Feature ID (On/Off cluster)
         if (feature_id == LOW_CODE_FEATURE_ID_POWER) { 
-            bool power_value = *(bool *)data->value.value;
+            bool power_value = low_code::feature_value<LOW_CODE_FEATURE_ID_POWER>(data);
             printf("%s: Feature update: power: %d\n", TAG, power_value);
             
             // Only trigger the pulse when the switch is turned ON
@@ -16,6 +16,7 @@
 
 #include <system.h>
 #include <low_code.h>
+#include <low_code_feature.h>
 
 #include "app_priv.h"
 
@@ -44,15 +45,15 @@ int feature_update_from_system(low_code_feature_data_t *data)
 
     if (endpoint_id == 1) {
         if (feature_id == LOW_CODE_FEATURE_ID_TEMPERATURE) {  // Temperature
-            int16_t temperature = *(int16_t *)data->value.value;
+            int16_t temperature = low_code::feature_value<LOW_CODE_FEATURE_ID_TEMPERATURE>(data);
             app_driver_set_temperature(temperature);
             printf("%s: Feature update: temperature: %d\n", TAG, temperature);
         } else if (feature_id == LOW_CODE_FEATURE_ID_COOLING_SETPOINT) {  // Cooling setpoint
-            int16_t cooling_setpoint = *(int16_t *)data->value.value;
+            int16_t cooling_setpoint = low_code::feature_value<LOW_CODE_FEATURE_ID_COOLING_SETPOINT>(data);
             app_driver_set_cooling_setpoint(cooling_setpoint);
             printf("%s: Feature update: cooling setpoint: %d\n", TAG, cooling_setpoint);
         } else if (feature_id == LOW_CODE_FEATURE_ID_HEATING_SETPOINT) {  // Heating setpoint
-            int16_t heating_setpoint = *(int16_t *)data->value.value;
+            int16_t heating_setpoint = low_code::feature_value<LOW_CODE_FEATURE_ID_HEATING_SETPOINT>(data);
             app_driver_set_heating_setpoint(heating_setpoint);
             printf("%s: Feature update: heating setpoint: %d\n", TAG, heating_setpoint);
         }
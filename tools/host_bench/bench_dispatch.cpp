@@ -0,0 +1,95 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Dispatch cost of feature updates through low_code.cpp, over the loopback transport */
+
+#include <stdio.h>
+#include <time.h>
+
+#include <low_code.h>
+#include <low_code_transport.h>
+#include <low_code_loopback.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define READ_CYCLES() __rdtsc()
+#else
+#define READ_CYCLES() 0
+#endif
+
+#define MESSAGES 1000000
+#define HANDLED_FEATURES 8
+
+static volatile uint32_t value_sum = 0;
+
+static int feature_update_from_system(low_code_feature_data_t *data)
+{
+    value_sum = value_sum + data->value.value[0];
+    return 0;
+}
+
+static int event_from_system(low_code_event_t *event)
+{
+    return 0;
+}
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void run(const char *name, bool use_handlers)
+{
+    uint8_t value = 1;
+    low_code_feature_data_t data = {
+        .details = {
+            .endpoint_id = 1,
+        },
+        .value = {
+            .type = LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER,
+            .value_len = sizeof(value),
+            .value = &value,
+        },
+    };
+
+    uint64_t dispatch_cycles = 0;
+    uint64_t start = time_ns();
+    for (int n = 0; n < MESSAGES; n++) {
+        data.details.feature_id = (low_code_feature_id_t)(use_handlers ? 1001 + n % HANDLED_FEATURES : 9001);
+        low_code_loopback_send_feature_update(&data);
+        uint64_t cycles = READ_CYCLES();
+        low_code_get_feature_update_from_system();
+        dispatch_cycles += READ_CYCLES() - cycles;
+    }
+    uint64_t elapsed = time_ns() - start;
+
+    printf("%-22s %10d %14.0f %12.1f %14.1f\n", name, MESSAGES, MESSAGES * 1e9 / elapsed, (double)elapsed / MESSAGES,
+           (double)dispatch_cycles / MESSAGES);
+}
+
+int main()
+{
+    low_code_transport_register_callbacks();
+    low_code_register_callbacks(feature_update_from_system, event_from_system);
+    for (int i = 0; i < HANDLED_FEATURES; i++) {
+        low_code_register_feature_handler(1, (low_code_feature_id_t)(1001 + i), feature_update_from_system);
+    }
+
+    printf("%-22s %10s %14s %12s %14s\n", "dispatch", "messages", "msgs/s", "ns/message", "cycles/message");
+    run("application callback", false);
+    run("feature handlers", true);
+    return 0;
+}
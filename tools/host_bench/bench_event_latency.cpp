@@ -0,0 +1,163 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Delivery latency of a factory reset event from the system, with and without feature traffic saturating the link
+ *
+ * Every loop iteration is a main loop of the subcore: low_code_get_feature_update_from_system() and
+ * low_code_get_event_from_system(), with each feature update taking FEATURE_WORK_NS to handle. Before each iteration
+ * the system raises an event every EVENT_INTERVAL iterations and sends it as soon as a buffer is free, then tops
+ * up the receive buffers with feature updates. The latency is measured from the event being raised on the system to its callback.
+ *
+ * With CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS the event goes to the priority endpoint, and the system keeps
+ * PRIORITY_RESERVED_BUFFERS receive buffers free of feature updates.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <esp_amp_host.h>
+#include <low_code.h>
+#include <low_code_transport.h>
+
+#define ESP_AMP_ENDPOINT_FEATURE 0
+#define ESP_AMP_ENDPOINT_EVENT 1
+#define ESP_AMP_ENDPOINT_EVENT_PRIORITY 4
+
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+#define EVENT_ENDPOINT ESP_AMP_ENDPOINT_EVENT_PRIORITY
+#define PRIORITY_RESERVED_BUFFERS 2
+#else
+#define EVENT_ENDPOINT ESP_AMP_ENDPOINT_EVENT
+#define PRIORITY_RESERVED_BUFFERS 0
+#endif
+
+#define ITERATIONS 200000
+#define EVENT_INTERVAL 64
+#define EVENTS (ITERATIONS / EVENT_INTERVAL)
+#define FEATURE_WORK_NS 2000
+
+static uint64_t event_raised_ns = 0;
+static uint64_t event_raised_iteration = 0;
+static uint64_t iteration = 0;
+static uint32_t latency_ns[EVENTS];
+static uint32_t latency_loops[EVENTS];
+static int events_received = 0;
+static uint32_t features_received = 0;
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int feature_update_from_system(low_code_feature_data_t *data)
+{
+    /* e.g. driving a LED strip */
+    uint64_t end = time_ns() + FEATURE_WORK_NS;
+    while (time_ns() < end) {
+    }
+    features_received++;
+    return 0;
+}
+
+static int event_from_system(low_code_event_t *event)
+{
+    if (events_received < EVENTS) {
+        latency_ns[events_received] = (uint32_t)(time_ns() - event_raised_ns);
+        latency_loops[events_received] = (uint32_t)(iteration - event_raised_iteration);
+    }
+    events_received++;
+    return 0;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void run(const char *name, bool feature_traffic)
+{
+    uint8_t feature_msg[sizeof(low_code_feature_data_t) + 1] = {0};
+    low_code_feature_data_t *feature = (low_code_feature_data_t *)feature_msg;
+    feature->details.endpoint_id = 1;
+    feature->details.feature_id = LOW_CODE_FEATURE_ID_BRIGHTNESS;
+    feature->value.type = LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER;
+    feature->value.value_len = 1;
+
+    low_code_event_t event = {
+        .event_type = LOW_CODE_EVENT_FACTORY_RESET,
+        .event_data_size = 0,
+        .event_data = NULL,
+    };
+
+    events_received = 0;
+    features_received = 0;
+    int events_sent = 0;
+    bool event_raised = false;
+    uint64_t start = time_ns();
+    for (iteration = 0; iteration < ITERATIONS; iteration++) {
+        /* System side */
+        while (esp_amp_host_recv_from_subcore(NULL, NULL, NULL) == 0) {
+        }
+        if (iteration % EVENT_INTERVAL == 0 && !event_raised) {
+            event_raised = true;
+            event_raised_ns = time_ns();
+            event_raised_iteration = iteration;
+        }
+        /* The event is sent before any further feature update */
+        if (event_raised && events_sent == events_received &&
+                esp_amp_host_send_to_subcore(EVENT_ENDPOINT, &event, sizeof(event)) == 0) {
+            events_sent++;
+        }
+        while (feature_traffic && esp_amp_host_rx_buffers_in_use() < ESP_AMP_HOST_QUEUE_LEN - PRIORITY_RESERVED_BUFFERS) {
+            esp_amp_host_send_to_subcore(ESP_AMP_ENDPOINT_FEATURE, feature_msg, sizeof(feature_msg));
+        }
+
+        /* Subcore main loop */
+        low_code_get_feature_update_from_system();
+        low_code_get_event_from_system();
+        if (events_received == events_sent) {
+            event_raised = false;
+        }
+    }
+    uint64_t elapsed = time_ns() - start;
+
+    int samples = events_received < EVENTS ? events_received : EVENTS;
+    qsort(latency_ns, samples, sizeof(latency_ns[0]), compare_u32);
+    qsort(latency_loops, samples, sizeof(latency_loops[0]), compare_u32);
+    printf("%-10s %12.0f %8d %10u %10u %10u %10u %10u\n", name, features_received * 1e9 / elapsed, samples,
+           latency_ns[samples / 2], latency_ns[samples * 99 / 100], latency_ns[samples - 1],
+           latency_loops[samples / 2], latency_loops[samples - 1]);
+}
+
+int main()
+{
+    low_code_transport_register_callbacks();
+    low_code_register_callbacks(feature_update_from_system, event_from_system);
+
+#if CONFIG_LOW_CODE_TRANSPORT_PRIORITY_EVENTS
+    printf("event lane: priority endpoint, %d receive buffers reserved\n", PRIORITY_RESERVED_BUFFERS);
+#else
+    printf("event lane: shared with feature updates\n");
+#endif
+    printf("%-10s %12s %8s %10s %10s %10s %10s %10s\n", "features", "features/s", "events", "p50 ns", "p99 ns",
+           "max ns", "p50 loops", "max loops");
+    run("idle", false);
+    run("saturated", true);
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Bytes copied per received feature update, with and without CONFIG_LOW_CODE_TRANSPORT_ZERO_COPY_RX */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <esp_amp_host.h>
+#include <low_code.h>
+#include <low_code_transport.h>
+
+#define ESP_AMP_ENDPOINT_FEATURE 0
+#define MESSAGES_PER_SIZE 100000
+
+static volatile uint32_t value_sum = 0;
+
+static int feature_update_from_system(low_code_feature_data_t *data)
+{
+    /* Touch the value so that the receive path cannot be optimised away */
+    value_sum = value_sum + data->value.value[data->value.value_len - 1];
+    return 0;
+}
+
+static int event_from_system(low_code_event_t *event)
+{
+    return 0;
+}
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int main()
+{
+    low_code_transport_register_callbacks();
+    low_code_register_callbacks(feature_update_from_system, event_from_system);
+
+#if CONFIG_LOW_CODE_TRANSPORT_ZERO_COPY_RX
+    printf("receive mode: zero copy\n");
+#else
+    printf("receive mode: copy\n");
+#endif
+    printf("%10s %12s %16s %12s\n", "value_len", "messages", "copied/message", "ns/message");
+
+    const int value_lens[] = {1, 4, 16, 64, 128, 256};
+    for (size_t i = 0; i < sizeof(value_lens) / sizeof(value_lens[0]); i++) {
+        uint8_t msg[sizeof(low_code_feature_data_t) + 256] = {0};
+        low_code_feature_data_t *data = (low_code_feature_data_t *)msg;
+        data->details.endpoint_id = 1;
+        data->details.feature_id = LOW_CODE_FEATURE_ID_BRIGHTNESS;
+        data->value.type = LOW_CODE_VALUE_TYPE_OCTET_STRING;
+        data->value.value_len = value_lens[i];
+        uint16_t msg_len = sizeof(low_code_feature_data_t) + value_lens[i];
+
+        low_code_transport_reset_stats();
+        uint64_t start = time_ns();
+        for (int n = 0; n < MESSAGES_PER_SIZE; n++) {
+            esp_amp_host_send_to_subcore(ESP_AMP_ENDPOINT_FEATURE, msg, msg_len);
+            low_code_get_feature_update_from_system();
+        }
+        uint64_t elapsed = time_ns() - start;
+
+        low_code_transport_stats_t stats;
+        low_code_transport_get_stats(&stats);
+        printf("%10d %12lu %16.1f %12.1f\n", value_lens[i], (unsigned long)stats.rx_messages,
+               (double)stats.rx_bytes_copied / stats.rx_messages, (double)elapsed / MESSAGES_PER_SIZE);
+    }
+
+    if (esp_amp_host_rx_buffers_in_use() != 0) {
+        printf("error: %d receive buffers were not released\n", esp_amp_host_rx_buffers_in_use());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Cost of sw_timer_run(), sw_timer_start() and sw_timer_stop() with 10 to 1000 timers, and the wakeups of an
+ * idle loop which sleeps until sw_timer_next_deadline() with and without slack */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sw_timer.h>
+
+#define MAX_TIMERS 1000
+#define RUN_CALLS 1000000
+#define START_CALLS 1000000
+#define FIRE_TIME_NS 500000000ull
+#define WAKEUP_TIMERS 20
+
+typedef struct {
+    sw_timer_handle_t handle;
+    int period_ms;
+    uint64_t started_ns;
+    uint32_t fires;
+} bench_timer_t;
+
+static bench_timer_t timers[MAX_TIMERS];
+static uint32_t early_fires = 0;
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void timer_cb(sw_timer_handle_t handle, void *arg)
+{
+    bench_timer_t *timer = (bench_timer_t *)arg;
+    timer->fires++;
+    /* A periodic timer must not fire before fires * period since it was started */
+    if (time_ns() - timer->started_ns < (uint64_t)timer->fires * timer->period_ms * 1000000) {
+        early_fires++;
+    }
+}
+
+static void timers_create(int count, int min_period_ms, int max_period_ms, int slack_percent = 0)
+{
+    for (int i = 0; i < count; i++) {
+        timers[i].period_ms = min_period_ms + rand() % (max_period_ms - min_period_ms + 1);
+        timers[i].fires = 0;
+        sw_timer_config_t cfg = {
+            .periodic = true,
+            .timeout_ms = timers[i].period_ms,
+            .handler = timer_cb,
+            .arg = &timers[i],
+            .slack_ms = timers[i].period_ms * slack_percent / 100,
+        };
+        timers[i].handle = sw_timer_create(&cfg);
+        timers[i].started_ns = time_ns();
+        sw_timer_start(timers[i].handle);
+    }
+}
+
+static void timers_delete(int count)
+{
+    for (int i = 0; i < count; i++) {
+        sw_timer_delete(timers[i].handle);
+    }
+}
+
+static void run(int count)
+{
+    srand(count);
+
+    /* Nothing due: the timers expire long after the measurement */
+    timers_create(count, 600000, 1200000);
+    uint64_t start = time_ns();
+    for (int n = 0; n < RUN_CALLS; n++) {
+        sw_timer_run();
+    }
+    double run_ns = (double)(time_ns() - start) / RUN_CALLS;
+
+    start = time_ns();
+    for (int n = 0; n < START_CALLS; n++) {
+        sw_timer_start(timers[rand() % count].handle);
+    }
+    double start_ns = (double)(time_ns() - start) / START_CALLS;
+
+    start = time_ns();
+    for (int n = 0; n < START_CALLS; n++) {
+        sw_timer_handle_t handle = timers[rand() % count].handle;
+        sw_timer_stop(handle);
+        sw_timer_start(handle);
+    }
+    double stop_start_ns = (double)(time_ns() - start) / START_CALLS;
+    timers_delete(count);
+
+    /* Firing: periods of 1 to 50 ms */
+    early_fires = 0;
+    timers_create(count, 1, 50);
+    uint64_t loops = 0;
+    start = time_ns();
+    uint64_t end = start + FIRE_TIME_NS;
+    uint64_t now;
+    while ((now = time_ns()) < end) {
+        sw_timer_run();
+        loops++;
+    }
+    uint64_t fires = 0;
+    uint64_t missed = 0;
+    for (int i = 0; i < count; i++) {
+        fires += timers[i].fires;
+        sw_timer_stats_t stats;
+        sw_timer_get_stats(timers[i].handle, &stats);
+        missed += stats.missed_count;
+    }
+    timers_delete(count);
+
+    printf("%6d %12.1f %12.1f %16.1f %10llu %8llu %12.0f %8lu\n", count, run_ns, start_ns, stop_start_ns,
+           (unsigned long long)fires, (unsigned long long)missed, (double)(now - start) / loops,
+           (unsigned long)early_fires);
+}
+
+/* Idle loop as in system_loop(): wait until the next deadline, then run the timers */
+static void wakeups(int slack_percent)
+{
+    srand(WAKEUP_TIMERS);
+    early_fires = 0;
+    timers_create(WAKEUP_TIMERS, 10, 50, slack_percent);
+    uint64_t loops = 0;
+    uint64_t start = time_ns();
+    uint64_t end = start + FIRE_TIME_NS;
+    while (time_ns() < end) {
+        uint32_t timeout_us = sw_timer_next_deadline();
+        if (timeout_us > 0) {
+            usleep(timeout_us);
+        }
+        sw_timer_run();
+        loops++;
+    }
+    uint64_t fires = 0;
+    uint32_t max_lateness_us = 0;
+    for (int i = 0; i < WAKEUP_TIMERS; i++) {
+        fires += timers[i].fires;
+        sw_timer_stats_t stats;
+        sw_timer_get_stats(timers[i].handle, &stats);
+        max_lateness_us = stats.max_lateness_us > max_lateness_us ? stats.max_lateness_us : max_lateness_us;
+    }
+    timers_delete(WAKEUP_TIMERS);
+
+    printf("%6d %8d%% %10llu %10llu %16lu %8lu\n", WAKEUP_TIMERS, slack_percent, (unsigned long long)loops,
+           (unsigned long long)fires, (unsigned long)max_lateness_us, (unsigned long)early_fires);
+}
+
+int main()
+{
+    printf("%6s %12s %12s %16s %10s %8s %12s %8s\n", "timers", "ns/run idle", "ns/start", "ns/stop+start",
+           "fires", "missed", "ns/run fire", "early");
+    run(10);
+    run(100);
+    run(1000);
+
+    printf("\n%6s %9s %10s %10s %16s %8s\n", "timers", "slack", "wakeups", "fires", "max lateness us", "early");
+    wakeups(0);
+    wakeups(25);
+    wakeups(50);
+    return 0;
+}
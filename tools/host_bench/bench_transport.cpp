@@ -0,0 +1,209 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* End-to-end transport throughput and round trip latency, over payload sizes and burst patterns
+ *
+ * The subcore sends bursts of feature updates (low_code_feature_update_to_system()) or events
+ * (low_code_event_to_system()). The system side echoes every message back as soon as it receives it, and the
+ * round trip ends when the echo is dispatched to the application callback. The system only services the
+ * subcore after a whole burst was sent, so bursts larger than the transmit buffers show allocation failures.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <esp_amp_host.h>
+#include <low_code.h>
+#include <low_code_transport.h>
+
+/* BUF_SIZE of low_code_transport.cpp, larger values are sent in fragments */
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+#define MAX_PAYLOAD 4000
+#else
+#define MAX_PAYLOAD 256
+#endif
+#define MESSAGES_PER_RUN 32768
+#define FEATURES_PER_BURST 64
+
+static uint64_t send_ns[256];
+static uint32_t latency_ns[MESSAGES_PER_RUN];
+static int received = 0;
+static uint64_t received_bytes = 0;
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The first byte of the payload is the sequence number, which finds the send time of the echo */
+static void record_echo(const uint8_t *payload, int len)
+{
+    if (received < MESSAGES_PER_RUN) {
+        latency_ns[received] = (uint32_t)(time_ns() - send_ns[payload[0]]);
+    }
+    received++;
+    received_bytes += len;
+}
+
+static int feature_update_from_system(low_code_feature_data_t *data)
+{
+    record_echo(data->value.value, data->value.value_len);
+    return 0;
+}
+
+static int event_from_system(low_code_event_t *event)
+{
+    record_echo((const uint8_t *)event->event_data, event->event_data_size);
+    return 0;
+}
+
+static int send_feature(uint8_t *payload, int len, int n)
+{
+    low_code_feature_data_t data = {
+        .details = {
+            .endpoint_id = 1,
+            /* A different feature for every message of a burst, so that nothing is coalesced */
+            .feature_id = (low_code_feature_id_t)(1000 + n % FEATURES_PER_BURST),
+        },
+        .value = {
+            .type = LOW_CODE_VALUE_TYPE_OCTET_STRING,
+            .value_len = len,
+            .value = payload,
+        },
+    };
+    return low_code_feature_update_to_system(&data);
+}
+
+static int send_event(uint8_t *payload, int len, int n)
+{
+    low_code_event_t event = {
+        .event_type = LOW_CODE_EVENT_READY,
+        .event_data_size = len,
+        .event_data = payload,
+    };
+    return low_code_event_to_system(&event);
+}
+
+/* System side: echo everything the subcore sent, then let the subcore dispatch the echoes */
+static bool service()
+{
+    uint8_t msg[ESP_AMP_HOST_MAX_MSG_SIZE];
+    uint16_t addr;
+    uint16_t len;
+    bool busy = false;
+    while (esp_amp_host_recv_from_subcore(&addr, msg, &len) == 0) {
+        esp_amp_host_send_to_subcore(addr, msg, len);
+        busy = true;
+    }
+    low_code_transport_flush_pending();
+    while (low_code_transport_rx_pending()) {
+        low_code_get_event_from_system();
+        low_code_get_feature_update_from_system();
+        busy = true;
+    }
+    return busy;
+}
+
+/* The transport prints every allocation failure, keep that out of the measurement */
+static int mute_stdout()
+{
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+    return saved;
+}
+
+static void unmute_stdout(int saved)
+{
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void run(const char *name, int (*send)(uint8_t *payload, int len, int n), int len, int burst)
+{
+    uint8_t payload[MAX_PAYLOAD];
+    memset(payload, 0xa5, sizeof(payload));
+    received = 0;
+    received_bytes = 0;
+    low_code_transport_reset_stats();
+
+    int saved_stdout = mute_stdout();
+    uint64_t start = time_ns();
+    for (int n = 0; n < MESSAGES_PER_RUN;) {
+        for (int i = 0; i < burst && n < MESSAGES_PER_RUN; i++, n++) {
+            payload[0] = (uint8_t)n;
+            send_ns[(uint8_t)n] = time_ns();
+            send(payload, len, n);
+        }
+        while (service()) {
+        }
+    }
+    uint64_t elapsed = time_ns() - start;
+    unmute_stdout(saved_stdout);
+
+    low_code_transport_stats_t stats;
+    low_code_transport_get_stats(&stats);
+    int samples = received < MESSAGES_PER_RUN ? received : MESSAGES_PER_RUN;
+    qsort(latency_ns, samples, sizeof(latency_ns[0]), compare_u32);
+    printf("%-8s %6d %6d %10d %12.0f %14.0f %10u %10u %12lu\n", name, len, burst, received, received * 1e9 / elapsed,
+           received_bytes * 1e9 / elapsed, samples ? latency_ns[samples / 2] : 0, samples ? latency_ns[samples * 99 / 100] : 0,
+           (unsigned long)stats.tx_alloc_failures);
+}
+
+int main()
+{
+    low_code_transport_register_callbacks();
+    low_code_register_callbacks(feature_update_from_system, event_from_system);
+
+    printf("%-8s %6s %6s %10s %12s %14s %10s %10s %12s\n", "message", "bytes", "burst", "delivered", "msgs/s", "bytes/s",
+           "p50 ns", "p99 ns", "alloc fails");
+#if CONFIG_LOW_CODE_TRANSPORT_FRAGMENTATION
+    const int lens[] = {1, 256, 1024, MAX_PAYLOAD};
+#else
+    const int lens[] = {1, 16, 64, 128, MAX_PAYLOAD};
+#endif
+    const int bursts[] = {1, 8, 32};
+    for (size_t b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++) {
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            run("feature", send_feature, lens[l], bursts[b]);
+        }
+    }
+    for (size_t b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++) {
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            run("event", send_event, lens[l], bursts[b]);
+        }
+    }
+
+    if (esp_amp_host_rx_buffers_in_use() != 0) {
+        printf("error: %d receive buffers were not released\n", esp_amp_host_rx_buffers_in_use());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Bytes copied per sent feature update: low_code_feature_update_to_system() vs low_code_feature_begin()/commit() */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <esp_amp_host.h>
+#include <low_code.h>
+#include <low_code_transport.h>
+
+#define MESSAGES_PER_SIZE 100000
+
+static int feature_update_from_system(low_code_feature_data_t *data)
+{
+    return 0;
+}
+
+static int event_from_system(low_code_event_t *event)
+{
+    return 0;
+}
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Produce a value, e.g. the zone noise levels of a sensor, straight into `out` */
+static void produce_value(uint8_t *out, int len)
+{
+    for (int i = 0; i < len; i++) {
+        out[i] = (uint8_t)i;
+    }
+}
+
+static void send_copy(int value_len)
+{
+    uint8_t value[256];
+    produce_value(value, value_len);
+    low_code_feature_data_t data = {
+        .details = {
+            .endpoint_id = 1,
+            .feature_id = LOW_CODE_FEATURE_ID_OCCUPANCY_SENSOR_VALUE,
+        },
+        .value = {
+            .type = LOW_CODE_VALUE_TYPE_ARRAY,
+            .value_len = value_len,
+            .value = value,
+        },
+    };
+    low_code_feature_update_to_system(&data);
+}
+
+static void send_in_place(int value_len)
+{
+    low_code_feature_data_t *data = low_code_feature_begin(value_len);
+    if (!data) {
+        return;
+    }
+    data->details.endpoint_id = 1;
+    data->details.feature_id = LOW_CODE_FEATURE_ID_OCCUPANCY_SENSOR_VALUE;
+    data->value.type = LOW_CODE_VALUE_TYPE_ARRAY;
+    produce_value(data->value.value, value_len);
+    low_code_feature_commit(data);
+}
+
+static void run(const char *name, void (*send)(int value_len))
+{
+    const int value_lens[] = {1, 16, 64, 256};
+    for (size_t i = 0; i < sizeof(value_lens) / sizeof(value_lens[0]); i++) {
+        low_code_transport_reset_stats();
+        uint64_t start = time_ns();
+        for (int n = 0; n < MESSAGES_PER_SIZE; n++) {
+            send(value_lens[i]);
+            /* System side */
+            esp_amp_host_recv_from_subcore(NULL, NULL, NULL);
+        }
+        uint64_t elapsed = time_ns() - start;
+
+        low_code_transport_stats_t stats;
+        low_code_transport_get_stats(&stats);
+        printf("%-14s %10d %12lu %16.1f %12.1f\n", name, value_lens[i], (unsigned long)stats.tx_messages,
+               (double)stats.tx_bytes_copied / stats.tx_messages, (double)elapsed / MESSAGES_PER_SIZE);
+    }
+}
+
+int main()
+{
+    low_code_transport_register_callbacks();
+    low_code_register_callbacks(feature_update_from_system, event_from_system);
+
+    printf("%-14s %10s %12s %16s %12s\n", "api", "value_len", "messages", "copied/message", "ns/message");
+    run("update", send_copy);
+    run("begin/commit", send_in_place);
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Message sizes of the raw and the compact wire format, and encode/decode round trip through the transport */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <esp_amp_host.h>
+#include <low_code.h>
+#include <low_code_transport.h>
+#include <low_code_transport_wire.h>
+
+#define ESP_AMP_ENDPOINT_FEATURE 0
+#define ESP_AMP_ENDPOINT_EVENT 1
+#define ROUND_TRIPS 100000
+
+/* Size of the raw structures on the LP core (RV32), which differs from the host */
+#define RAW_FEATURE_HEADER_LEN_RV32 36
+#define RAW_EVENT_HEADER_LEN_RV32 12
+
+typedef struct {
+    const char *name;
+    uint16_t endpoint_id;
+    low_code_feature_id_t feature_id;
+    low_code_feature_value_type_t type;
+    int value_len;
+} sample_feature_t;
+
+static const sample_feature_t samples[] = {
+    {"power (bool)", 1, LOW_CODE_FEATURE_ID_POWER, LOW_CODE_VALUE_TYPE_BOOLEAN, 1},
+    {"brightness (u8)", 1, LOW_CODE_FEATURE_ID_BRIGHTNESS, LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER, 1},
+    {"color temp (u16)", 1, LOW_CODE_FEATURE_ID_COLOR_TEMPERATURE, LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER, 2},
+    {"temperature (i16)", 1, LOW_CODE_FEATURE_ID_TEMPERATURE_SENSOR_VALUE, LOW_CODE_VALUE_TYPE_INTEGER, 2},
+    {"zone noise (u16[16])", 1, LOW_CODE_FEATURE_ID_OCCUPANCY_SENSOR_VALUE, LOW_CODE_VALUE_TYPE_ARRAY, 32},
+    {"octet string (128)", 2, LOW_CODE_FEATURE_ID_MAX, LOW_CODE_VALUE_TYPE_OCTET_STRING, 128},
+};
+
+static int feature_update_from_system(low_code_feature_data_t *data)
+{
+    return 0;
+}
+
+static int event_from_system(low_code_event_t *event)
+{
+    return 0;
+}
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void print_sizes(const char *name, int raw_len, int compact_len)
+{
+    printf("%-22s %10d %10d %9.0f%%\n", name, raw_len, compact_len, 100.0 * compact_len / raw_len);
+}
+
+int main()
+{
+    low_code_transport_register_callbacks();
+    low_code_register_callbacks(feature_update_from_system, event_from_system);
+
+    printf("%-22s %10s %10s %10s\n", "message", "raw", "compact", "ratio");
+    uint8_t value[256];
+    uint8_t msg[ESP_AMP_HOST_MAX_MSG_SIZE];
+    for (size_t i = 0; i < sizeof(value); i++) {
+        value[i] = (uint8_t)i;
+    }
+
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        low_code_feature_data_t data = {
+            .details = {
+                .endpoint_id = samples[i].endpoint_id,
+                .feature_id = samples[i].feature_id,
+            },
+            .value = {
+                .type = samples[i].type,
+                .value_len = samples[i].value_len,
+                .value = value,
+            },
+        };
+        low_code_feature_update_to_system(&data);
+
+        /* Decode on the system side and check the round trip */
+        uint16_t addr, msg_len;
+        low_code_feature_data_t decoded;
+        if (esp_amp_host_recv_from_subcore(&addr, msg, &msg_len) != 0 || addr != ESP_AMP_ENDPOINT_FEATURE ||
+                low_code_wire_decode_feature(msg, msg_len, &decoded) != msg_len ||
+                decoded.details.endpoint_id != data.details.endpoint_id || decoded.details.feature_id != data.details.feature_id ||
+                decoded.value.type != data.value.type || decoded.value.value_len != data.value.value_len ||
+                memcmp(decoded.value.value, value, data.value.value_len) != 0) {
+            printf("error: %s does not round trip\n", samples[i].name);
+            return 1;
+        }
+        print_sizes(samples[i].name, RAW_FEATURE_HEADER_LEN_RV32 + samples[i].value_len, msg_len);
+    }
+
+    low_code_event_t event = {
+        .event_type = LOW_CODE_EVENT_FACTORY_RESET,
+        .event_data_size = 0,
+        .event_data = NULL,
+    };
+    low_code_event_to_system(&event);
+    uint16_t msg_len;
+    esp_amp_host_recv_from_subcore(NULL, msg, &msg_len);
+    print_sizes("event (no data)", RAW_EVENT_HEADER_LEN_RV32, msg_len);
+
+    /* Receive path: the system sends compact messages, the transport decodes and dispatches them */
+    low_code_feature_data_t data = {
+        .details = {
+            .endpoint_id = 1,
+            .feature_id = LOW_CODE_FEATURE_ID_BRIGHTNESS,
+        },
+        .value = {
+            .type = LOW_CODE_VALUE_TYPE_UNSIGNED_INTEGER,
+            .value_len = 1,
+            .value = value,
+        },
+    };
+    size_t header_len = low_code_wire_feature_header_len(&data);
+    size_t record_len = low_code_wire_encode_feature_header(&data, msg, header_len);
+    msg[header_len] = value[0];
+
+    low_code_transport_reset_stats();
+    uint64_t start = time_ns();
+    for (int n = 0; n < ROUND_TRIPS; n++) {
+        esp_amp_host_send_to_subcore(ESP_AMP_ENDPOINT_FEATURE, msg, record_len);
+        low_code_get_feature_update_from_system();
+    }
+    uint64_t elapsed = time_ns() - start;
+    low_code_transport_stats_t stats;
+    low_code_transport_get_stats(&stats);
+    printf("\ndecode and dispatch: %lu messages, %.1f ns/message\n", (unsigned long)stats.rx_messages, (double)elapsed / ROUND_TRIPS);
+    return 0;
+}
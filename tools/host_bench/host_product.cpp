@@ -0,0 +1,163 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Runs the unmodified logic of a product (products/<name>/main) on the host, with this harness as the system.
+ *
+ * The product is built with main renamed to product_main. Its main loop calls the harness on every
+ * system_loop() through the loop hook, where the harness sends feature updates and events and checks what the
+ * product reports. The product is configured with:
+ *   HOST_PRODUCT_NAME         name to print
+ *   HOST_PRODUCT_FEATURE_ID   feature of endpoint 1 which the system sends
+ *   HOST_PRODUCT_VALUE_TYPE   LOW_CODE_VALUE_TYPE_BOOLEAN or LOW_CODE_VALUE_TYPE_INTEGER (int16_t)
+ *   HOST_PRODUCT_BUTTON_GPIO  button which toggles the feature, if any
+ *   HOST_PRODUCT_RELAY_GPIO   relay switched by the button
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <low_code.h>
+#include <low_code_transport.h>
+#include <low_code_loopback.h>
+#include <system_host.h>
+#include <drivers_host.h>
+
+#define FEATURE_UPDATES 100000
+
+extern "C" int product_main();
+
+typedef enum {
+    STATE_READY_EVENT,
+    STATE_THROUGHPUT,
+    STATE_BUTTON,
+    STATE_DONE,
+} harness_state_t;
+
+static harness_state_t state = STATE_READY_EVENT;
+static int sent = 0;
+static uint64_t start_ns = 0;
+static uint64_t loops = 0;
+static int saved_stdout = -1;
+
+static uint64_t time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* The products print every update they handle, keep that out of the measurement */
+static void mute_stdout(bool mute)
+{
+    fflush(stdout);
+    if (mute) {
+        saved_stdout = dup(STDOUT_FILENO);
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    } else if (saved_stdout >= 0) {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        saved_stdout = -1;
+    }
+}
+
+static int send_feature_update(int n)
+{
+#if HOST_PRODUCT_VALUE_TYPE == LOW_CODE_VALUE_TYPE_BOOLEAN
+    bool value = n & 1;
+#else
+    int16_t value = (int16_t)(n % 3000);
+#endif
+    low_code_feature_data_t data = {
+        .details = {
+            .endpoint_id = 1,
+            .feature_id = HOST_PRODUCT_FEATURE_ID,
+        },
+        .value = {
+            .type = HOST_PRODUCT_VALUE_TYPE,
+            .value_len = sizeof(value),
+            .value = (uint8_t *)&value,
+        },
+    };
+    return low_code_loopback_send_feature_update(&data);
+}
+
+static void print_reports()
+{
+    low_code_feature_data_t data;
+    uint8_t value[LOW_CODE_LOOPBACK_MAX_VALUE_LEN];
+    while (low_code_loopback_receive_feature_update(&data, value, sizeof(value)) == ESP_OK) {
+        printf("system: feature update: endpoint: %u, feature: %u, value_len: %d, value[0]: %u\n",
+                data.details.endpoint_id, (unsigned)data.details.feature_id, data.value.value_len, value[0]);
+    }
+    low_code_event_t event;
+    while (low_code_loopback_receive_event(&event, value, sizeof(value)) == ESP_OK) {
+        printf("system: event: %d\n", event.event_type);
+    }
+}
+
+static void harness_loop()
+{
+    loops++;
+    switch (state) {
+    case STATE_READY_EVENT: {
+        low_code_event_t event = {
+            .event_type = LOW_CODE_EVENT_READY,
+        };
+        low_code_loopback_send_event(&event);
+        state = STATE_THROUGHPUT;
+        break;
+    }
+    case STATE_THROUGHPUT:
+        if (sent == 0) {
+            mute_stdout(true);
+            loops = 0;
+            start_ns = time_ns();
+        }
+        /* Keep the queue full, the product handles one update per loop */
+        while (sent < FEATURE_UPDATES && send_feature_update(sent) == ESP_OK) {
+            sent++;
+        }
+        if (sent == FEATURE_UPDATES && !low_code_transport_rx_pending()) {
+            uint64_t elapsed = time_ns() - start_ns;
+            mute_stdout(false);
+            printf("%s: %d feature updates in %llu loops, %.0f msgs/s, %.1f ns/message\n", HOST_PRODUCT_NAME,
+                    FEATURE_UPDATES, (unsigned long long)loops, FEATURE_UPDATES * 1e9 / elapsed, (double)elapsed / FEATURE_UPDATES);
+            print_reports();
+            state = STATE_BUTTON;
+        }
+        break;
+    case STATE_BUTTON:
+#ifdef HOST_PRODUCT_BUTTON_GPIO
+        host_button_emit(HOST_PRODUCT_BUTTON_GPIO, BUTTON_SINGLE_CLICK);
+        print_reports();
+        printf("system: relay power: %d\n", host_relay_get_power(HOST_PRODUCT_RELAY_GPIO));
+#endif
+        state = STATE_DONE;
+        break;
+    case STATE_DONE:
+        exit(0);
+    }
+}
+
+int main()
+{
+    host_system_set_loop_hook(harness_loop);
+    return product_main();
+}
@@ -0,0 +1,155 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Button, relay and light drivers on the host: they keep their state in memory for the harness */
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <button_driver.h>
+#include <relay_driver.h>
+#include <light_driver.h>
+
+#include "drivers_host.h"
+
+#define HOST_BUTTON_NUM 4
+#define HOST_RELAY_NUM 32
+
+typedef struct {
+    bool valid;
+    int gpio_num;
+    button_cb_t cb[BUTTON_EVENT_MAX];
+    void *usr_data[BUTTON_EVENT_MAX];
+} host_button_t;
+
+static host_button_t buttons[HOST_BUTTON_NUM];
+static bool relay_power[HOST_RELAY_NUM];
+static bool light_power = false;
+
+button_handle_t button_driver_create(const button_config_t *config)
+{
+    for (int i = 0; i < HOST_BUTTON_NUM; i++) {
+        if (!buttons[i].valid) {
+            buttons[i] = (host_button_t) {
+                .valid = true,
+                .gpio_num = config->gpio_num,
+            };
+            return &buttons[i];
+        }
+    }
+    return NULL;
+}
+
+int button_driver_delete(button_handle_t btn_handle)
+{
+    if (!btn_handle) {
+        return -1;
+    }
+    ((host_button_t *)btn_handle)->valid = false;
+    return 0;
+}
+
+int button_driver_register_cb(button_handle_t btn_handle, button_event_t event, button_cb_t cb, void *usr_data)
+{
+    if (!btn_handle || event >= BUTTON_EVENT_MAX) {
+        return -1;
+    }
+    host_button_t *button = (host_button_t *)btn_handle;
+    button->cb[event] = cb;
+    button->usr_data[event] = usr_data;
+    return 0;
+}
+
+int button_driver_unregister_cb(button_handle_t btn_handle, button_event_t event)
+{
+    return button_driver_register_cb(btn_handle, event, NULL, NULL);
+}
+
+int host_button_emit(int gpio_num, button_event_t event)
+{
+    for (int i = 0; i < HOST_BUTTON_NUM; i++) {
+        if (buttons[i].valid && buttons[i].gpio_num == gpio_num) {
+            if (buttons[i].cb[event]) {
+                buttons[i].cb[event](&buttons[i], buttons[i].usr_data[event]);
+            }
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void relay_driver_init(int gpio_num)
+{
+}
+
+void relay_driver_set_power(int gpio_num, bool power)
+{
+    if (gpio_num >= 0 && gpio_num < HOST_RELAY_NUM) {
+        relay_power[gpio_num] = power;
+    }
+}
+
+bool host_relay_get_power(int gpio_num)
+{
+    return gpio_num >= 0 && gpio_num < HOST_RELAY_NUM && relay_power[gpio_num];
+}
+
+int light_driver_init(light_driver_config_t *config)
+{
+    return 0;
+}
+
+int light_driver_set_power(uint8_t val)
+{
+    light_power = val;
+    return 0;
+}
+
+int light_driver_set_brightness(uint8_t val)
+{
+    return 0;
+}
+
+int light_driver_set_hue(uint16_t val)
+{
+    return 0;
+}
+
+int light_driver_set_saturation(uint8_t val)
+{
+    return 0;
+}
+
+int light_driver_set_temperature(uint32_t val)
+{
+    return 0;
+}
+
+int light_driver_set_color_mode(uint8_t val)
+{
+    return 0;
+}
+
+void light_driver_effect_start(light_effect_config_t *effect, int speed, int total_ms)
+{
+}
+
+void light_driver_effect_stop(void)
+{
+}
+
+bool host_light_get_power(void)
+{
+    return light_power;
+}
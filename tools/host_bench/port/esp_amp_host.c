@@ -0,0 +1,203 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_amp.h"
+#include "esp_amp_host.h"
+#include "esp_amp_sw_intr.h"
+#include "esp_amp_platform.h"
+
+typedef struct {
+    void *data;
+    uint16_t data_len;
+    uint16_t addr;
+} host_msg_t;
+
+typedef struct {
+    host_msg_t msgs[ESP_AMP_HOST_QUEUE_LEN];
+    int head;
+    int count;
+} host_queue_t;
+
+/* to_subcore: system -> subcore, to_system: subcore -> system */
+static host_queue_t to_subcore;
+static host_queue_t to_system;
+
+/* Buffers are a limited resource on the target, count them to fail allocations the same way */
+static int tx_buffers_in_use;
+static int rx_buffers_in_use;
+
+/* One handler per software interrupt is enough for the components built on the host */
+static esp_amp_sw_intr_handler_t sw_intr_handlers[SW_INTR_ID_MAX];
+static void *sw_intr_args[SW_INTR_ID_MAX];
+
+static int host_queue_push(host_queue_t *queue, void *data, uint16_t data_len, uint16_t addr)
+{
+    if (queue->count >= ESP_AMP_HOST_QUEUE_LEN) {
+        return -1;
+    }
+    host_msg_t *msg = &queue->msgs[(queue->head + queue->count) % ESP_AMP_HOST_QUEUE_LEN];
+    msg->data = data;
+    msg->data_len = data_len;
+    msg->addr = addr;
+    queue->count++;
+    return 0;
+}
+
+static int host_queue_pop(host_queue_t *queue, host_msg_t *msg)
+{
+    if (queue->count == 0) {
+        return -1;
+    }
+    *msg = queue->msgs[queue->head];
+    queue->head = (queue->head + 1) % ESP_AMP_HOST_QUEUE_LEN;
+    queue->count--;
+    return 0;
+}
+
+int esp_amp_init(void)
+{
+    return 0;
+}
+
+int esp_amp_rpmsg_sub_init(esp_amp_rpmsg_dev_t *rpmsg_dev, bool notify, bool poll)
+{
+    rpmsg_dev->ept_list = NULL;
+    return 0;
+}
+
+esp_amp_rpmsg_ept_t *esp_amp_rpmsg_create_endpoint(esp_amp_rpmsg_dev_t *rpmsg_dev, uint16_t ept_addr, esp_amp_ept_cb_t ept_rx_cb, void *ept_rx_cb_data, esp_amp_rpmsg_ept_t *ept_ctx)
+{
+    ept_ctx->addr = ept_addr;
+    ept_ctx->rx_cb = ept_rx_cb;
+    ept_ctx->rx_cb_data = ept_rx_cb_data;
+    ept_ctx->next = rpmsg_dev->ept_list;
+    rpmsg_dev->ept_list = ept_ctx;
+    return ept_ctx;
+}
+
+void *esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t *rpmsg_dev, uint32_t nbytes, uint16_t flags)
+{
+    if (nbytes > ESP_AMP_HOST_MAX_MSG_SIZE || tx_buffers_in_use >= ESP_AMP_HOST_QUEUE_LEN) {
+        return NULL;
+    }
+    void *data = malloc(nbytes ? nbytes : 1);
+    if (data) {
+        tx_buffers_in_use++;
+    }
+    return data;
+}
+
+int esp_amp_rpmsg_send_nocopy(esp_amp_rpmsg_dev_t *rpmsg_dev, esp_amp_rpmsg_ept_t *ept, uint16_t dst_addr, void *data, uint16_t data_len)
+{
+    return host_queue_push(&to_system, data, data_len, dst_addr);
+}
+
+int esp_amp_rpmsg_destroy(esp_amp_rpmsg_dev_t *rpmsg_dev, void *msg_data)
+{
+    free(msg_data);
+    rx_buffers_in_use--;
+    return 0;
+}
+
+int esp_amp_rpmsg_poll(esp_amp_rpmsg_dev_t *rpmsg_dev)
+{
+    host_msg_t msg;
+    if (host_queue_pop(&to_subcore, &msg) != 0) {
+        return -1;
+    }
+    for (esp_amp_rpmsg_ept_t *ept = rpmsg_dev->ept_list; ept; ept = ept->next) {
+        if (ept->addr == msg.addr) {
+            return ept->rx_cb(msg.data, msg.data_len, msg.addr, ept->rx_cb_data);
+        }
+    }
+    esp_amp_rpmsg_destroy(rpmsg_dev, msg.data);
+    return 0;
+}
+
+uint16_t esp_amp_rpmsg_get_max_size(esp_amp_rpmsg_dev_t *rpmsg_dev)
+{
+    return ESP_AMP_HOST_MAX_MSG_SIZE;
+}
+
+int esp_amp_event_notify(uint32_t event)
+{
+    return 0;
+}
+
+int esp_amp_sw_intr_add_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_handler_t handler, void *arg)
+{
+    if (intr_id >= SW_INTR_ID_MAX || sw_intr_handlers[intr_id]) {
+        return -1;
+    }
+    sw_intr_handlers[intr_id] = handler;
+    sw_intr_args[intr_id] = arg;
+    return 0;
+}
+
+uint32_t esp_amp_platform_get_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+int esp_amp_host_send_to_subcore(uint16_t dst_addr, const void *data, uint16_t data_len)
+{
+    if (data_len > ESP_AMP_HOST_MAX_MSG_SIZE || rx_buffers_in_use >= ESP_AMP_HOST_QUEUE_LEN) {
+        return -1;
+    }
+    void *msg = malloc(data_len ? data_len : 1);
+    if (!msg) {
+        return -1;
+    }
+    memcpy(msg, data, data_len);
+    if (host_queue_push(&to_subcore, msg, data_len, dst_addr) != 0) {
+        free(msg);
+        return -1;
+    }
+    rx_buffers_in_use++;
+    if (sw_intr_handlers[SW_INTR_ID_VQ_MSG]) {
+        sw_intr_handlers[SW_INTR_ID_VQ_MSG](sw_intr_args[SW_INTR_ID_VQ_MSG]);
+    }
+    return 0;
+}
+
+int esp_amp_host_recv_from_subcore(uint16_t *dst_addr, void *data, uint16_t *data_len)
+{
+    host_msg_t msg;
+    if (host_queue_pop(&to_system, &msg) != 0) {
+        return -1;
+    }
+    if (dst_addr) {
+        *dst_addr = msg.addr;
+    }
+    if (data_len) {
+        *data_len = msg.data_len;
+    }
+    if (data) {
+        memcpy(data, msg.data, msg.data_len);
+    }
+    free(msg.data);
+    tx_buffers_in_use--;
+    return 0;
+}
+
+int esp_amp_host_rx_buffers_in_use(void)
+{
+    return rx_buffers_in_use;
+}
@@ -0,0 +1,49 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file drivers_host.h
+ * @brief Host harness hooks of the button, relay and light driver stand-ins
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <button_driver.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Call the callback registered for a button event, as if the button was used
+ * @param gpio_num GPIO of the button
+ * @param event Button event
+ * @return 0 on success, -1 if no button uses the GPIO
+ */
+int host_button_emit(int gpio_num, button_event_t event);
+
+/**
+ * @brief Get the power of a relay
+ */
+bool host_relay_get_power(int gpio_num);
+
+/**
+ * @brief Get the power of the light
+ */
+bool host_light_get_power(void);
+
+#ifdef __cplusplus
+}
+#endif
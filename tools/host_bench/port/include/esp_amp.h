@@ -0,0 +1,60 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file esp_amp.h
+ * @brief Host stand-in for the subset of ESP AMP used by the LowCode components
+ *
+ * Messages are kept in in-process queues instead of the shared memory vrings. The system (HP core)
+ * side of the link is driven by the host harness through esp_amp_host.h.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_AMP_RPMSG_DATA_DEFAULT 0
+
+typedef int (*esp_amp_ept_cb_t)(void *msg_data, uint16_t data_len, uint16_t src_addr, void *rx_cb_data);
+
+typedef struct esp_amp_rpmsg_ept {
+    uint16_t addr;
+    esp_amp_ept_cb_t rx_cb;
+    void *rx_cb_data;
+    struct esp_amp_rpmsg_ept *next;
+} esp_amp_rpmsg_ept_t;
+
+typedef struct {
+    esp_amp_rpmsg_ept_t *ept_list;
+} esp_amp_rpmsg_dev_t;
+
+int esp_amp_init(void);
+int esp_amp_rpmsg_sub_init(esp_amp_rpmsg_dev_t *rpmsg_dev, bool notify, bool poll);
+esp_amp_rpmsg_ept_t *esp_amp_rpmsg_create_endpoint(esp_amp_rpmsg_dev_t *rpmsg_dev, uint16_t ept_addr, esp_amp_ept_cb_t ept_rx_cb, void *ept_rx_cb_data, esp_amp_rpmsg_ept_t *ept_ctx);
+void *esp_amp_rpmsg_create_message(esp_amp_rpmsg_dev_t *rpmsg_dev, uint32_t nbytes, uint16_t flags);
+int esp_amp_rpmsg_send_nocopy(esp_amp_rpmsg_dev_t *rpmsg_dev, esp_amp_rpmsg_ept_t *ept, uint16_t dst_addr, void *data, uint16_t data_len);
+int esp_amp_rpmsg_destroy(esp_amp_rpmsg_dev_t *rpmsg_dev, void *msg_data);
+int esp_amp_rpmsg_poll(esp_amp_rpmsg_dev_t *rpmsg_dev);
+uint16_t esp_amp_rpmsg_get_max_size(esp_amp_rpmsg_dev_t *rpmsg_dev);
+int esp_amp_event_notify(uint32_t event);
+
+#ifdef __cplusplus
+}
+#endif
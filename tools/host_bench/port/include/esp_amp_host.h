@@ -0,0 +1,59 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file esp_amp_host.h
+ * @brief System (HP core) side of the host ESP AMP stand-in
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of messages in flight in each direction, like the buffers of a vring */
+#define ESP_AMP_HOST_QUEUE_LEN 16
+
+/** @brief Maximum size of a message */
+#define ESP_AMP_HOST_MAX_MSG_SIZE 512
+
+/**
+ * @brief Send a message from the system to an endpoint of the subcore
+ *
+ * The message is copied into a new receive buffer and dispatched on the next esp_amp_rpmsg_poll().
+ * @return 0 on success, -1 if the queue is full or the message is too large
+ */
+int esp_amp_host_send_to_subcore(uint16_t dst_addr, const void *data, uint16_t data_len);
+
+/**
+ * @brief Receive the oldest message sent by the subcore
+ *
+ * @param[out] dst_addr Endpoint the message was sent to
+ * @param[out] data Buffer of at least ESP_AMP_HOST_MAX_MSG_SIZE bytes, may be NULL to drop the message
+ * @param[out] data_len Length of the message
+ * @return 0 on success, -1 if there is no message
+ */
+int esp_amp_host_recv_from_subcore(uint16_t *dst_addr, void *data, uint16_t *data_len);
+
+/**
+ * @brief Number of receive buffers which the subcore has not destroyed yet
+ */
+int esp_amp_host_rx_buffers_in_use(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file esp_amp_sw_intr.h
+ * @brief Host stand-in for the ESP AMP software interrupts
+ *
+ * Handlers of SW_INTR_ID_VQ_MSG are called when the host harness sends a message to the subcore.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SW_INTR_ID_0 = 0,
+    SW_INTR_ID_1,
+    SW_INTR_ID_2,
+    SW_INTR_ID_3,
+    SW_INTR_ID_VQ_MSG,
+    SW_INTR_ID_MAX,
+} esp_amp_sw_intr_id_t;
+
+typedef int (*esp_amp_sw_intr_handler_t)(void *arg);
+
+int esp_amp_sw_intr_add_handler(esp_amp_sw_intr_id_t intr_id, esp_amp_sw_intr_handler_t handler, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
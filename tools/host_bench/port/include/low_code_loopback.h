@@ -0,0 +1,77 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file low_code_loopback.h
+ * @brief System (HP core) side of the host loopback transport
+ *
+ * The loopback transport implements low_code_transport.h over in-process ring buffers instead of ESP AMP, so
+ * that low_code and product logic can run on the host. Feature updates and events keep their in-memory
+ * representation, there is no wire format. The host harness uses this API to play the role of the system.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <low_code.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of messages which can be queued in each direction, for each of feature updates and events */
+#define LOW_CODE_LOOPBACK_QUEUE_LEN 16
+
+/** @brief Maximum length of a feature value or event data */
+#define LOW_CODE_LOOPBACK_MAX_VALUE_LEN 256
+
+/**
+ * @brief Send a feature update from the system
+ *
+ * The update and its value are copied, it is dispatched on a later low_code_get_feature_update_from_system().
+ * @param[in] data Feature update
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the queue is full, ESP_ERR_INVALID_SIZE if the value is too long
+ */
+int low_code_loopback_send_feature_update(const low_code_feature_data_t *data);
+
+/**
+ * @brief Send an event from the system
+ *
+ * The event and its data are copied, it is dispatched on a later low_code_get_event_from_system().
+ * @param[in] event Event
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the queue is full, ESP_ERR_INVALID_SIZE if the data is too long
+ */
+int low_code_loopback_send_event(const low_code_event_t *event);
+
+/**
+ * @brief Receive the oldest feature update sent to the system
+ * @param[out] data Feature update, value.value points to `value`
+ * @param[out] value Buffer for the value
+ * @param[in] value_size Size of the buffer, longer values are truncated
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no update
+ */
+int low_code_loopback_receive_feature_update(low_code_feature_data_t *data, uint8_t *value, int value_size);
+
+/**
+ * @brief Receive the oldest event sent to the system
+ * @param[out] event Event, event_data points to `data`
+ * @param[out] data Buffer for the event data
+ * @param[in] data_size Size of the buffer, longer data is truncated
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no event
+ */
+int low_code_loopback_receive_event(low_code_event_t *event, uint8_t *data, int data_size);
+
+#ifdef __cplusplus
+}
+#endif
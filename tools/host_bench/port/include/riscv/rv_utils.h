@@ -0,0 +1,57 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file rv_utils.h
+ * @brief Host stand-in for the RISC-V CSR access used by the LowCode components
+ *
+ * mcycle is emulated from the monotonic clock as a 32 bit counter at the LP core frequency (16 MHz).
+ * There are no interrupts on the host, mstatus is a plain variable.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint32_t esp_host_read_mcycle(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec) * 16 / 1000);
+}
+
+#define RV_READ_CSR(reg) esp_host_read_mcycle()
+
+#define MSTATUS_MIE 0x00000008
+
+static unsigned long esp_host_mstatus = MSTATUS_MIE;
+
+static inline unsigned long esp_host_clear_mstatus(unsigned long bits)
+{
+    unsigned long old = esp_host_mstatus;
+    esp_host_mstatus &= ~bits;
+    return old;
+}
+
+static inline unsigned long esp_host_set_mstatus(unsigned long bits)
+{
+    unsigned long old = esp_host_mstatus;
+    esp_host_mstatus |= bits;
+    return old;
+}
+
+#define RV_CLEAR_CSR(reg, bits) esp_host_clear_mstatus(bits)
+#define RV_SET_CSR(reg, bits) esp_host_set_mstatus(bits)
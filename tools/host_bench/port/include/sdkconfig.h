@@ -0,0 +1,2 @@
+/* Host stand-in: the configuration is passed as compile definitions by CMakeLists.txt */
+#pragma once
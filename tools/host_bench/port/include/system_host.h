@@ -0,0 +1,49 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file system_host.h
+ * @brief Host harness hooks of the host system.h implementation
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Function called at the start of every system_loop(), e.g. to play the role of the system */
+typedef void (*host_system_loop_hook_t)(void);
+
+/**
+ * @brief Set the function called at the start of every system_loop()
+ *
+ * The product main loop never returns, the hook ends the run with exit() when it is done.
+ * @param hook Loop hook, NULL to remove it
+ */
+void host_system_set_loop_hook(host_system_loop_hook_t hook);
+
+/**
+ * @brief Get the level set on a GPIO with system_digital_write()
+ */
+int host_system_get_pin_level(int gpio_num);
+
+/**
+ * @brief Set the level returned by system_digital_read() for a GPIO
+ */
+void host_system_set_pin_level(int gpio_num, int level);
+
+#ifdef __cplusplus
+}
+#endif
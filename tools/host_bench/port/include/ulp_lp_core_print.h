@@ -0,0 +1,2 @@
+/* Host stand-in: sw_timer only needs this header to exist */
+#pragma once
@@ -0,0 +1,2 @@
+/* Host stand-in: the LowCode transport only needs this header to exist */
+#pragma once
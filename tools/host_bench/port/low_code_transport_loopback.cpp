@@ -0,0 +1,257 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Loopback transport: low_code_transport.h implemented over in-process ring buffers, see low_code_loopback.h */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <low_code.h>
+#include <low_code_transport.h>
+#include <low_code_loopback.h>
+
+typedef struct {
+    union {
+        low_code_feature_data_t feature;
+        low_code_event_t event;
+    };
+    uint8_t value[LOW_CODE_LOOPBACK_MAX_VALUE_LEN];
+} loopback_msg_t;
+
+typedef struct {
+    loopback_msg_t msgs[LOW_CODE_LOOPBACK_QUEUE_LEN];
+    int head;
+    int count;
+} loopback_queue_t;
+
+static const char *TAG = "low_code_loopback";
+
+static loopback_queue_t features_to_subcore;
+static loopback_queue_t events_to_subcore;
+static loopback_queue_t features_to_system;
+static loopback_queue_t events_to_system;
+
+static low_code_transport_stats_t transport_stats;
+
+static loopback_msg_t *queue_tail(loopback_queue_t *queue)
+{
+    if (queue->count >= LOW_CODE_LOOPBACK_QUEUE_LEN) {
+        return NULL;
+    }
+    return &queue->msgs[(queue->head + queue->count) % LOW_CODE_LOOPBACK_QUEUE_LEN];
+}
+
+static loopback_msg_t *queue_head(loopback_queue_t *queue)
+{
+    return queue->count ? &queue->msgs[queue->head] : NULL;
+}
+
+static void queue_pop(loopback_queue_t *queue)
+{
+    queue->head = (queue->head + 1) % LOW_CODE_LOOPBACK_QUEUE_LEN;
+    queue->count--;
+}
+
+static int feature_push(loopback_queue_t *queue, const low_code_feature_data_t *data)
+{
+    if (data->value.value_len < 0 || data->value.value_len > LOW_CODE_LOOPBACK_MAX_VALUE_LEN) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    loopback_msg_t *msg = queue_tail(queue);
+    if (!msg) {
+        return ESP_ERR_NO_MEM;
+    }
+    msg->feature = *data;
+    memcpy(msg->value, data->value.value, data->value.value_len);
+    msg->feature.value.value = msg->value;
+    queue->count++;
+    return ESP_OK;
+}
+
+static int event_push(loopback_queue_t *queue, const low_code_event_t *event)
+{
+    if (event->event_data_size < 0 || event->event_data_size > LOW_CODE_LOOPBACK_MAX_VALUE_LEN) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    loopback_msg_t *msg = queue_tail(queue);
+    if (!msg) {
+        return ESP_ERR_NO_MEM;
+    }
+    msg->event = *event;
+    memcpy(msg->value, event->event_data, event->event_data_size);
+    msg->event.event_data = msg->value;
+    queue->count++;
+    return ESP_OK;
+}
+
+static int loopback_event_to_system(low_code_event_t *event)
+{
+    int ret = event_push(&events_to_system, event);
+    if (ret != ESP_OK) {
+        printf("%s: Failed to send event: %d\n", TAG, ret);
+        return ret;
+    }
+    transport_stats.tx_messages++;
+    transport_stats.tx_bytes += sizeof(low_code_event_t) + event->event_data_size;
+    transport_stats.tx_bytes_copied += event->event_data_size;
+    return ESP_OK;
+}
+
+static int loopback_feature_update_to_system(low_code_feature_data_t *data)
+{
+    int ret = feature_push(&features_to_system, data);
+    if (ret != ESP_OK) {
+        printf("%s: Failed to send feature update: %d\n", TAG, ret);
+        return ret;
+    }
+    transport_stats.tx_messages++;
+    transport_stats.tx_bytes += sizeof(low_code_feature_data_t) + data->value.value_len;
+    transport_stats.tx_bytes_copied += data->value.value_len;
+    return ESP_OK;
+}
+
+/* The message stays in the queue while it is dispatched, so the value is handed out in place */
+static int loopback_get_event_from_system()
+{
+    loopback_msg_t *msg = queue_head(&events_to_subcore);
+    if (msg) {
+        transport_stats.rx_messages++;
+        transport_stats.rx_bytes += sizeof(low_code_event_t) + msg->event.event_data_size;
+        low_code_event_from_transport(&msg->event);
+        queue_pop(&events_to_subcore);
+    }
+    return ESP_OK;
+}
+
+static int loopback_get_feature_update_from_system()
+{
+    loopback_msg_t *msg = queue_head(&features_to_subcore);
+    if (msg) {
+        transport_stats.rx_messages++;
+        transport_stats.rx_bytes += sizeof(low_code_feature_data_t) + msg->feature.value.value_len;
+        low_code_feature_update_from_transport(&msg->feature);
+        queue_pop(&features_to_subcore);
+    }
+    return ESP_OK;
+}
+
+static uint32_t loopback_get_time_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+int low_code_transport_register_callbacks()
+{
+    low_code_callback_list_t callbacks_list = {
+        .event_cb = loopback_event_to_system,
+        .feature_update_cb = loopback_feature_update_to_system,
+        .get_event = loopback_get_event_from_system,
+        .get_feature_update = loopback_get_feature_update_from_system,
+        .feature_update_batch_cb = NULL,
+        .hold_rx_buffer = NULL,
+        .release_rx_buffer = NULL,
+        .feature_begin = NULL,
+        .feature_commit = NULL,
+        .get_time_ms = loopback_get_time_ms,
+    };
+    int ret = low_code_register_transport_callbacks(&callbacks_list);
+    if (ret != ESP_OK) {
+        printf("%s: Failed to register Low Code transport callbacks\n", TAG);
+    }
+    return ret;
+}
+
+int low_code_transport_get_stats(low_code_transport_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = transport_stats;
+    return ESP_OK;
+}
+
+void low_code_transport_reset_stats(void)
+{
+    memset(&transport_stats, 0, sizeof(transport_stats));
+}
+
+void low_code_transport_dump_stats(void)
+{
+    printf("%s: rx: %u msgs %u bytes, tx: %u msgs %u bytes\n", TAG, transport_stats.rx_messages,
+           transport_stats.rx_bytes, transport_stats.tx_messages, transport_stats.tx_bytes);
+}
+
+void low_code_transport_flush_pending(void)
+{
+}
+
+bool low_code_transport_rx_pending(void)
+{
+    return features_to_subcore.count > 0 || events_to_subcore.count > 0;
+}
+
+bool low_code_transport_rx_doorbell_confirmed(void)
+{
+    return false;
+}
+
+bool low_code_transport_tx_pending(void)
+{
+    return false;
+}
+
+int low_code_loopback_send_feature_update(const low_code_feature_data_t *data)
+{
+    return feature_push(&features_to_subcore, data);
+}
+
+int low_code_loopback_send_event(const low_code_event_t *event)
+{
+    return event_push(&events_to_subcore, event);
+}
+
+int low_code_loopback_receive_feature_update(low_code_feature_data_t *data, uint8_t *value, int value_size)
+{
+    loopback_msg_t *msg = queue_head(&features_to_system);
+    if (!msg) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *data = msg->feature;
+    if (data->value.value_len > value_size) {
+        data->value.value_len = value_size;
+    }
+    memcpy(value, msg->value, data->value.value_len);
+    data->value.value = value;
+    queue_pop(&features_to_system);
+    return ESP_OK;
+}
+
+int low_code_loopback_receive_event(low_code_event_t *event, uint8_t *data, int data_size)
+{
+    loopback_msg_t *msg = queue_head(&events_to_system);
+    if (!msg) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *event = msg->event;
+    if (event->event_data_size > data_size) {
+        event->event_data_size = data_size;
+    }
+    memcpy(data, msg->value, event->event_data_size);
+    event->event_data = data;
+    queue_pop(&events_to_system);
+    return ESP_OK;
+}
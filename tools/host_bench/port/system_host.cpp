@@ -0,0 +1,171 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* system.h on the host: software timers run on the emulated mcycle, GPIOs are kept in memory */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <sw_timer.h>
+#include <low_code_transport.h>
+#include <profiler.h>
+
+#include <system.h>
+#include <system_host.h>
+
+#define HOST_GPIO_NUM 32
+
+static host_system_loop_hook_t loop_hook = NULL;
+static int pin_levels[HOST_GPIO_NUM];
+
+static void host_sleep_us(uint64_t us)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(us / 1000000),
+        .tv_nsec = (long)(us % 1000000) * 1000,
+    };
+    nanosleep(&ts, NULL);
+}
+
+void host_system_set_loop_hook(host_system_loop_hook_t hook)
+{
+    loop_hook = hook;
+}
+
+int host_system_get_pin_level(int gpio_num)
+{
+    return gpio_num >= 0 && gpio_num < HOST_GPIO_NUM ? pin_levels[gpio_num] : 0;
+}
+
+void host_system_set_pin_level(int gpio_num, int level)
+{
+    if (gpio_num >= 0 && gpio_num < HOST_GPIO_NUM) {
+        pin_levels[gpio_num] = level;
+    }
+}
+
+void system_loop()
+{
+    if (loop_hook) {
+        loop_hook();
+    }
+    system_snapshot_replay();
+    low_code_transport_flush_pending();
+    system_timer_update();
+    system_run_jobs();
+    profiler_loop_end(0);
+}
+
+void system_setup()
+{
+    low_code_transport_register_callbacks();
+    system_snapshot_restore();
+}
+
+void system_timer_update()
+{
+    sw_timer_run();
+}
+
+void system_wakeup()
+{
+}
+
+int system_get_idle_stats(system_idle_stats_t *stats)
+{
+    if (!stats) {
+        return -1;
+    }
+    memset(stats, 0, sizeof(*stats));
+    return 0;
+}
+
+void system_reset_idle_stats()
+{
+}
+
+void system_sleep(uint32_t seconds)
+{
+    host_sleep_us((uint64_t)seconds * 1000000);
+}
+
+void system_delay(uint32_t seconds)
+{
+    host_sleep_us((uint64_t)seconds * 1000000);
+}
+
+void system_delay_ms(uint32_t ms)
+{
+    host_sleep_us((uint64_t)ms * 1000);
+}
+
+void system_delay_us(uint32_t us)
+{
+    host_sleep_us(us);
+}
+
+uint32_t system_get_time()
+{
+    return (uint32_t)system_clock_ms();
+}
+
+system_timer_handle_t system_timer_create(system_timer_cb_t callback, void *arg, int timeout_ms, bool periodic)
+{
+    sw_timer_config_t timer_cfg = {
+        .periodic = periodic,
+        .timeout_ms = timeout_ms,
+        .handler = callback,
+        .arg = arg
+    };
+    return sw_timer_create(&timer_cfg);
+}
+
+int system_timer_start(system_timer_handle_t handle)
+{
+    return sw_timer_start(handle);
+}
+
+int system_timer_stop(system_timer_handle_t handle)
+{
+    return sw_timer_stop(handle);
+}
+
+int system_timer_delete(system_timer_handle_t handle)
+{
+    return sw_timer_delete(handle);
+}
+
+int system_timer_set_slack(system_timer_handle_t handle, int slack_ms)
+{
+    return sw_timer_set_slack(handle, slack_ms);
+}
+
+void system_enable_software_interrupt()
+{
+}
+
+void system_set_pin_mode(int gpio_num, pin_mode_t mode)
+{
+}
+
+void system_digital_write(int gpio_num, pin_level_t level)
+{
+    host_system_set_pin_level(gpio_num, level);
+}
+
+int system_digital_read(int gpio_num)
+{
+    return host_system_get_pin_level(gpio_num);
+}